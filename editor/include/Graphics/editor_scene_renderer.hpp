@@ -13,6 +13,9 @@ namespace Engine
 	public:
 		EditorSceneRenderer();
 
+		// Selected primitives write their bounds to the overlay pass, which is not thread safe
+		bool supports_parallel_recording() const override;
+
 		// Components rendering
 		using ColorSceneRenderer::render_component;
 		EditorSceneRenderer& render_component(LightComponent* component) override;
@@ -287,6 +287,11 @@ namespace Engine
 			ImGui::TextColored(color, "Delta Time: %f", dt);
 			ImGui::TextColored(color, "FPS: %f", m_average_fps.average());
 			ImGui::TextColored(color, "Visible objects: %zu", m_statistics.visible_objects);
+			ImGui::TextColored(color, "Frame allocations: %zu", m_statistics.frame_allocations);
+			ImGui::TextColored(color, "Frame arena peak: %.2f KB", static_cast<float>(m_statistics.peak_arena_usage) / 1024.f);
+			ImGui::TextColored(color, "Skipped binds: material %zu, buffer %zu", m_statistics.material_binds_skipped,
+			                   m_statistics.buffer_binds_skipped);
+			ImGui::TextColored(color, "Instanced draws: %zu (%zu instances)", m_statistics.instanced_draws, m_statistics.instances);
 		}
 		ImGui::EndVertical();
 		return *this;
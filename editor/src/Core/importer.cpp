@@ -3,6 +3,7 @@
 #include <Core/importer.hpp>
 #include <Core/logger.hpp>
 #include <Core/package.hpp>
+#include <Core/parallel.hpp>
 #include <Graphics/gpu_buffers.hpp>
 #include <Graphics/mesh.hpp>
 #include <Graphics/texture_2D.hpp>
@@ -194,14 +195,24 @@ namespace Engine::Importer
 				surface.base_vertex_index = positions.size();
 				surface.first_index       = indices.size();
 
-				for (unsigned int i = 0; i < mesh->mNumVertices; ++i)
-				{
-					positions.push_back(vector_cast(transform * Vector4D(vector_from_assimp_vec(mesh->mVertices[i]), 1.f)));
-					normals.push_back(glm::normalize(rotation * vector_from_assimp_vec(mesh->mNormals[i])));
-					tangents.push_back(glm::normalize(rotation * vector_from_assimp_vec(mesh->mTangents[i])));
-					bitangents.push_back(glm::normalize(rotation * vector_from_assimp_vec(mesh->mBitangents[i])));
-					uvs.push_back(vector_from_assimp_vec(texture_coords[i]));
-				}
+				const size_t first_vertex = positions.size();
+				const size_t last_vertex  = first_vertex + mesh->mNumVertices;
+
+				positions.resize(last_vertex);
+				normals.resize(last_vertex);
+				tangents.resize(last_vertex);
+				bitangents.resize(last_vertex);
+				uvs.resize(last_vertex);
+
+				parallel_for(mesh->mNumVertices, 0, [&](size_t i) {
+					const size_t vertex = first_vertex + i;
+
+					positions[vertex]  = vector_cast(transform * Vector4D(vector_from_assimp_vec(mesh->mVertices[i]), 1.f));
+					normals[vertex]    = glm::normalize(rotation * vector_from_assimp_vec(mesh->mNormals[i]));
+					tangents[vertex]   = glm::normalize(rotation * vector_from_assimp_vec(mesh->mTangents[i]));
+					bitangents[vertex] = glm::normalize(rotation * vector_from_assimp_vec(mesh->mBitangents[i]));
+					uvs[vertex]        = vector_from_assimp_vec(texture_coords[i]);
+				});
 
 				for (unsigned int face_index = 0; face_index < mesh->mNumFaces; ++face_index)
 				{
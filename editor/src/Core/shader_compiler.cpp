@@ -187,14 +187,15 @@ namespace Engine::ShaderCompiler
 			Strings::to_lower(name);
 
 			static const TreeMap<String, VertexBufferSemantic> semantics = {
-					{"position", VertexBufferSemantic::Position},       //
-					{"texcoord", VertexBufferSemantic::TexCoord},       //
-					{"color", VertexBufferSemantic::Color},             //
-					{"normal", VertexBufferSemantic::Normal},           //
-					{"tangent", VertexBufferSemantic::Tangent},         //
-					{"bitangent", VertexBufferSemantic::Bitangent},     //
-					{"blendweight", VertexBufferSemantic::BlendWeight}, //
-					{"blendindices", VertexBufferSemantic::BlendIndices}//
+					{"position", VertexBufferSemantic::Position},        //
+					{"texcoord", VertexBufferSemantic::TexCoord},        //
+					{"color", VertexBufferSemantic::Color},              //
+					{"normal", VertexBufferSemantic::Normal},            //
+					{"tangent", VertexBufferSemantic::Tangent},          //
+					{"bitangent", VertexBufferSemantic::Bitangent},      //
+					{"blendweight", VertexBufferSemantic::BlendWeight},  //
+					{"blendindices", VertexBufferSemantic::BlendIndices},//
+					{"transform", VertexBufferSemantic::Transform}       //
 			};
 
 			auto it = semantics.find(name);
@@ -310,13 +311,14 @@ namespace Engine::ShaderCompiler
 					return false;
 				}
 
-				if (is_not_in<VertexBufferSemantic::Position, //
-							  VertexBufferSemantic::TexCoord, //
-							  VertexBufferSemantic::Color,    //
-							  VertexBufferSemantic::Normal,   //
-							  VertexBufferSemantic::Tangent,  //
-							  VertexBufferSemantic::Bitangent,//
-							  VertexBufferSemantic::BlendWeight>(attribute.semantic))
+				if (is_not_in<VertexBufferSemantic::Position,   //
+							  VertexBufferSemantic::TexCoord,   //
+							  VertexBufferSemantic::Color,      //
+							  VertexBufferSemantic::Normal,     //
+							  VertexBufferSemantic::Tangent,    //
+							  VertexBufferSemantic::Bitangent,  //
+							  VertexBufferSemantic::BlendWeight,//
+							  VertexBufferSemantic::Transform>(attribute.semantic))
 				{
 					error_log("ShaderCompiler", "Semantic '%s' doesn't support vector type!", var->getSemanticName());
 					return false;
@@ -324,7 +326,8 @@ namespace Engine::ShaderCompiler
 
 				attribute.semantic_index = var->getSemanticIndex();
 				attribute.name           = var->getName();
-				attribute.rate           = VertexAttributeInputRate::Vertex;
+				attribute.rate           = attribute.semantic == VertexBufferSemantic::Transform ? VertexAttributeInputRate::Instance
+																								 : VertexAttributeInputRate::Vertex;
 				attribute.type           = find_vertex_element_type(var->getTypeLayout(), attribute.semantic);
 				attribute.location       = var->getBindingIndex();
 				attribute.stream_index   = attribute.location;
@@ -213,6 +213,11 @@ namespace Engine
 		m_overlay_pass = create_pass<EditorOverlayPass>();
 	}
 
+	bool EditorSceneRenderer::supports_parallel_recording() const
+	{
+		return false;
+	}
+
 	EditorSceneRenderer& EditorSceneRenderer::render_component(LightComponent* component)
 	{
 		ColorSceneRenderer::render_component(component);
@@ -1,4 +1,5 @@
 #include <Clients/imgui_client.hpp>
+#include <Core/asset_registry.hpp>
 #include <Core/constants.hpp>
 #include <Core/filesystem/directory_iterator.hpp>
 #include <Core/filesystem/root_filesystem.hpp>
@@ -63,7 +64,7 @@ namespace Engine
 
 		if (is_editable && ImGui::Button("editor/Save"_localized))
 		{
-			m_show_popup_for->save();
+			m_show_popup_for->save_async();
 			return false;
 		}
 
@@ -90,7 +91,7 @@ namespace Engine
 
 			if (is_editable && ImGui::Button("editor/Save"_localized))
 			{
-				m_show_popup_for->save();
+				m_show_popup_for->save_async();
 				ImGui::CloseCurrentPopup();
 			}
 
@@ -158,7 +159,14 @@ namespace Engine
 			auto window                      = ImGuiWindow::current()->widgets_list.create_identified<ImGuiOpenFile>(this, flags);
 			window->on_select.push([](const Path& path) {
 				Path relative = path.relative(rootfs()->native_path(Project::assets_dir));
-				Object::load_object_from_file(relative);
+				String name   = Strings::replace_all(relative.base_path(), Path::sv_separator, Constants::name_separator);
+
+				if (!name.empty())
+					name += Constants::name_separator;
+				name += relative.stem();
+
+				// Dependencies of the asset are read concurrently, the asset is finalized after them
+				AssetRegistry::prefetch({name}).back().wait();
 			});
 			window->type_filters({Constants::asset_extention});
 			window->pwd(Project::assets_dir);
@@ -415,7 +423,7 @@ namespace Engine
 
 			if (is_editable_object && ImGui::Button("editor/Save"_localized))
 			{
-				selected_object->save();
+				Package::save_object_async(selected_object);
 				ImGui::CloseCurrentPopup();
 			}
 			ImGui::EndPopup();
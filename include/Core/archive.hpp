@@ -1,13 +1,58 @@
 #pragma once
 #include <Core/enums.hpp>
+#include <Core/etl/map.hpp>
+#include <Core/etl/span.hpp>
 #include <Core/etl/string.hpp>
 #include <Core/etl/type_traits.hpp>
+#include <Core/etl/vector.hpp>
 #include <Core/flags.hpp>
+#include <Core/name.hpp>
+#include <Core/serializer.hpp>
 
 namespace Engine
 {
 	class BufferReader;
 	class BufferWriter;
+	class Archive;
+
+	// Deduplicated names and imported objects of the asset. Archive which uses the tables stores names and references as
+	// indices, so each unique string is written and hashed only once per asset
+	class ENGINE_EXPORT ArchiveTables final
+	{
+	public:
+		static constexpr inline uint32_t none_index = ~static_cast<uint32_t>(0);
+
+	private:
+		Vector<Name> m_names;
+		Vector<String> m_imports;
+		Vector<class Object*> m_resolved_imports;
+		Vector<bool> m_is_import_resolved;
+
+		Map<Name, uint32_t, Name::HashFunction> m_name_indices;
+		Map<String, uint32_t> m_import_indices;
+		Map<class Object*, uint32_t> m_object_indices;
+		bool m_is_transient;
+
+	public:
+		// Transient tables store the imported objects instead of their names. They are used by in-memory copies of the
+		// objects and cannot be serialized
+		ArchiveTables(bool is_transient = false);
+
+		uint32_t name_index(const Name& name);
+		uint32_t import_index(const String& name);
+		uint32_t import_index(class Object* object);
+
+		const Name& name(uint32_t index) const;
+		class Object* import_object(uint32_t index);
+		ArchiveTables& import_object(uint32_t index, class Object* object);
+		bool is_transient() const;
+
+		const Vector<Name>& names() const;
+		const Vector<String>& imports() const;
+		const Vector<class Object*>& resolved_imports() const;
+
+		bool serialize(Archive& ar);
+	};
 
 	class ENGINE_EXPORT Archive
 	{
@@ -18,8 +63,9 @@ namespace Engine
 			BufferWriter* m_writer;
 		};
 
-		bool m_is_saving      = false;
-		bool m_process_status = true;
+		ArchiveTables* m_tables = nullptr;
+		bool m_is_saving        = false;
+		bool m_process_status   = true;
 
 		template<typename Type>
 		static auto address_of(Type& value)
@@ -34,8 +80,40 @@ namespace Engine
 			}
 		}
 
+		// Elements which are serialized as raw bytes can be written and read by one call
+		template<typename Type>
+		static constexpr bool is_bulk_serializable =
+		        std::is_trivially_copyable_v<Type> && !std::is_pointer_v<Type> && !Concepts::is_serializable<Type> &&
+		        !Concepts::is_serializable<Serializer<Type>, Type&> && !Concepts::is_reflected_struct<Type>;
+
+		// Size of the scalars which must be swapped if the data was written with different byte order, or 0 if unknown
+		template<typename Type>
+		static consteval size_t bulk_swap_unit()
+		{
+			if constexpr (std::is_arithmetic_v<Type> || std::is_enum_v<Type>)
+			{
+				return sizeof(Type);
+			}
+			else if constexpr (requires { typename Type::value_type; })
+			{
+				using Scalar = typename Type::value_type;
+
+				if constexpr (std::is_arithmetic_v<Scalar> && sizeof(Type) % sizeof(Scalar) == 0)
+					return sizeof(Scalar);
+				else
+					return 0;
+			}
+			else
+			{
+				return 0;
+			}
+		}
+
 		bool serialize_struct(Refl::Struct* self, void* obj);
-		class Object* load_object(const StringView& name, class Refl::Class* self);
+		bool serialize_object_reference(class Object*& object, class Refl::Class* self);
+		bool serialize_bulk_count(size_t& count, size_t element_size, bool& is_swapped);
+		bool serialize_bulk_data(byte* data, size_t size, size_t swap_unit, bool is_swapped);
+		static class Object* load_object(const StringView& name);
 
 	public:
 		Flags<SerializationFlags> flags;
@@ -54,9 +132,16 @@ namespace Engine
 		BufferReader* reader() const;
 		BufferWriter* writer() const;
 
+		ArchiveTables* tables() const;
+		Archive& tables(ArchiveTables* tables);
+
 		Archive& write_data(const byte* data, size_t size);
 		Archive& read_data(byte* data, size_t size);
 
+		// Reads the byte buffer serialized as vector. If the reader is memory based, span points directly to its content,
+		// otherwise the data is copied into the storage
+		bool read_buffer_view(Span<const byte>& span, Buffer& storage);
+
 		size_t position() const;
 		Archive& position(size_t position);
 		bool is_open() const;
@@ -111,29 +196,12 @@ namespace Engine
 		template<typename Type>
 		typename std::enable_if<std::is_base_of_v<class Engine::Object, Type>, bool>::type serialize_reference(Type*& object)
 		{
-			if (is_saving())
-			{
-				String name = object ? object->full_name() : "";
-				size_t size = name.length();
-				serialize(size);
-				write_data(reinterpret_cast<const byte*>(name.data()), size);
-			}
-			else if (is_reading())
-			{
-				String name;
-				size_t size;
-				serialize(size);
-				name.resize(size);
-				read_data(reinterpret_cast<byte*>(name.data()), size);
+			Object* reference = object;
+			serialize_object_reference(reference, Type::static_class_instance());
 
-				if (name.empty())
-				{
-					object = nullptr;
-				}
-				else
-				{
-					object = reinterpret_cast<Type*>(load_object(name, Type::static_class_instance()));
-				}
+			if (is_reading())
+			{
+				object = reinterpret_cast<Type*>(reference);
 			}
 
 			return *this;
@@ -142,31 +210,39 @@ namespace Engine
 		template<typename Type>
 		FORCE_INLINE bool serialize_vector(Type& vector)
 		{
+			using Element = typename Type::value_type;
+
 			size_t size = vector.size();
 			Archive& ar = *this;
-			serialize(size);
 
-			if (ar.is_reading())
+			if constexpr (is_bulk_serializable<Element>)
 			{
-				vector.resize(size);
-			}
+				bool is_swapped = false;
 
-			if constexpr (std::is_trivially_copyable_v<Type>)
-			{
-				byte* data   = reinterpret_cast<byte*>(vector.data());
-				size_t bytes = size * sizeof(Type);
+				if (!serialize_bulk_count(size, sizeof(Element), is_swapped))
+					return false;
 
 				if (ar.is_reading())
 				{
-					ar.read_data(data, bytes);
-				}
-				else if (ar.is_saving())
-				{
-					ar.write_data(data, bytes);
+					vector.clear();
+					vector.reserve(size);
+					vector.resize(size);
 				}
+
+				serialize_bulk_data(reinterpret_cast<byte*>(vector.data()), size * sizeof(Element), bulk_swap_unit<Element>(),
+				                    is_swapped);
 			}
 			else
 			{
+				serialize(size);
+
+				if (ar.is_reading())
+				{
+					vector.clear();
+					vector.reserve(size);
+					vector.resize(size);
+				}
+
 				for (auto& ell : vector)
 				{
 					serialize(ell);
@@ -256,6 +332,8 @@ namespace Engine
 		}
 
 		bool serialize_string(String& value);
+
+		friend class ArchiveTables;
 	};
 
 	template<>
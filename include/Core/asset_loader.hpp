@@ -0,0 +1,78 @@
+#pragma once
+#include <Core/callback.hpp>
+#include <Core/enums.hpp>
+#include <Core/etl/smart_ptr.hpp>
+#include <Core/etl/string.hpp>
+
+namespace Engine
+{
+	class Object;
+
+	// Handle of the asynchronous load request. Handles must be used only from the logic thread
+	class ENGINE_EXPORT LoadHandle final
+	{
+	public:
+		struct Request;
+
+	private:
+		SharedPtr<Request> m_request;
+
+		LoadHandle(const SharedPtr<Request>& request);
+
+	public:
+		LoadHandle();
+
+		bool is_valid() const;
+
+		// Returns true if the request was completed, failed or cancelled
+		bool is_finished() const;
+		bool is_cancelled() const;
+		float progress() const;
+
+		// Loaded object, or nullptr if the request is not finished or failed
+		Object* object() const;
+
+		// Callback is called on the logic thread. If the request is already finished, callback is called immediately
+		const LoadHandle& on_finished(const CallBack<void(Object*)>& callback) const;
+
+		// Dependencies which were requested by this request are not cancelled, they can be shared with other requests
+		const LoadHandle& cancel() const;
+
+		// Updates the loader until the request is finished. Must be called from the logic thread
+		Object* wait() const;
+
+		friend class AssetLoader;
+	};
+
+	// Loader reads and decompresses assets on the worker threads. Objects are created, deserialized and post loaded on
+	// the logic thread during the update, so render resources are initialized the same way as in the synchronous loading.
+	// References of the asset are read from its header and requested concurrently, and the object is created only when all
+	// of them are read
+	class ENGINE_EXPORT AssetLoader final
+	{
+	private:
+		static void dispatch_requests();
+		static void finalize_request(const SharedPtr<LoadHandle::Request>& request);
+		static Object* load_request(const SharedPtr<LoadHandle::Request>& request);
+
+		static bool is_resolving_references();
+		static Object* resolve_reference(StringView fullname);
+		static size_t missing_dependencies_count();
+
+	public:
+		// Requests of the same asset are merged, the priority of the merged request is raised if needed
+		static LoadHandle load(StringView fullname, LoadPriority priority = LoadPriority::Normal);
+
+		// Called by the engine once per frame
+		static void update();
+
+		static size_t pending_count();
+
+		// Progress of all requests which were created since the loader was idle last time
+		static float progress();
+
+		friend class Archive;
+		friend class Object;
+		friend class LoadHandle;
+	};
+}// namespace Engine
@@ -0,0 +1,55 @@
+#pragma once
+#include <Core/asset_loader.hpp>
+#include <Core/etl/string.hpp>
+#include <Core/etl/vector.hpp>
+
+namespace Engine
+{
+	class Archive;
+
+	// Dependency graph of the project assets. Each asset file stores the list of the assets which it references in the
+	// uncompressed header, so the graph is built without deserialization of the objects
+	class ENGINE_EXPORT AssetRegistry final
+	{
+	public:
+		struct Header {
+			Vector<String> dependencies;
+			HashIndex content_hash = 0;// Hash of the uncompressed data, used to skip saving of unchanged assets
+		};
+
+		// Writes the file flag, the dependencies and the content hash of the asset
+		static bool write_header(Archive& ar, const Header& header);
+
+		// Reads the header written by write_header. If header is nullptr, it is skipped. Assets saved without the header
+		// are accepted, the header is empty in this case
+		static bool read_header(Archive& ar, Header* header);
+
+		// Reads headers of all assets in the assets directory in parallel. Previous content of the registry is replaced
+		static size_t scan();
+
+		// Reads the header of the asset file again
+		static bool refresh(StringView fullname);
+		static void update(StringView fullname, const Header& header);
+		static void remove(StringView fullname);
+
+		// Returns true if the asset file is known and stores the content with the same hash. Registry is updated on each
+		// save, so this check doesn't access the file system
+		static bool is_saved(StringView fullname, HashIndex content_hash);
+		static bool contains(StringView fullname);
+		static Vector<String> assets();
+		static Vector<String> dependencies(StringView fullname);
+		static Vector<String> referencers(StringView fullname);
+
+		// All assets required by the roots, including the roots. Dependencies are placed before the assets which use them
+		static Vector<String> dependency_closure(const Vector<String>& roots);
+
+		// Assets which reference the asset directly or indirectly, their caches must be invalidated when the asset is changed
+		static Vector<String> referencer_closure(StringView fullname);
+
+		// Assets which are not reachable from the roots
+		static Vector<String> unused_assets(const Vector<String>& roots);
+
+		// Requests loading of the whole dependency closure. Assets are read concurrently by the asset loader
+		static Vector<LoadHandle> prefetch(const Vector<String>& roots, LoadPriority priority = LoadPriority::Normal);
+	};
+}// namespace Engine
@@ -1,6 +1,7 @@
 #pragma once
 
-#include <Core/etl/critical_section.hpp>
+#include <Core/etl/atomic.hpp>
+#include <Core/etl/average.hpp>
 #include <Core/etl/engine_resource.hpp>
 #include <Core/flags.hpp>
 #include <Core/object.hpp>
@@ -11,6 +12,18 @@ namespace Engine
 	{
 		declare_class(BaseEngine, Object);
 
+	public:
+		struct FrameStatistics {
+			float frame_time  = 0.f;
+			float logic_time  = 0.f;
+			float render_time = 0.f;
+			float wait_time   = 0.f;
+
+			// 0 - logic and render threads are working in lock-step, 1 - frame time is equal to the slowest thread
+			float overlap = 0.f;
+		};
+
+	private:
 		Index m_frame_index;
 		float m_delta_time;
 		float m_prev_time;
@@ -24,9 +37,19 @@ namespace Engine
 
 		Flags<Flag> m_flags;
 
-	protected:
-		CriticalSection m_render_end_signal;
+		Index m_submitted_frames = 0;
+		Atomic<Index> m_rendered_frames;
+		Atomic<float> m_render_time;
+		float m_render_start_time;
+
+		Average<float, 60> m_average_logic_time;
+		Average<float, 60> m_average_render_time;
+		Average<float, 60> m_average_wait_time;
+		Average<float, 60> m_average_frame_time;
+		FrameStatistics m_frame_statistics;
 
+		BaseEngine& wait_for_render_thread();
+		BaseEngine& update_frame_statistics(float logic_time, float wait_time);
 
 	public:
 		BaseEngine();
@@ -44,6 +67,11 @@ namespace Engine
 		float delta_time() const;
 		float time_seconds() const;
 		Index frame_index() const;
+
+		// Count of frames which the logic thread can record ahead of the render thread. Proxies keep a single copy of their
+		// state, because it is written only by render thread commands, which copy values when enqueued and run in order
+		Index frames_in_flight() const;
+		const FrameStatistics& frame_statistics() const;
 		bool is_shuting_down() const;
 		bool is_inited() const;
 		BaseEngine& make_inited();
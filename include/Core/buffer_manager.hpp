@@ -1,5 +1,6 @@
 #pragma once
 #include <Core/enums.hpp>
+#include <Core/etl/span.hpp>
 #include <Core/exception.hpp>
 
 namespace Engine
@@ -43,11 +44,17 @@ namespace Engine
 		size_t size();
 		BufferReader& position(ReadPos pos);
 
+		// Returns span of the next size bytes without copying them, if the reader has its content in memory
+		bool read_span(Span<const byte>& span, size_t size);
+
 		virtual bool read(byte* data, size_t size)                                                 = 0;
 		virtual ReadPos position()                                                                 = 0;
 		virtual BufferReader& offset(PosOffset offset, BufferSeekDir dir = BufferSeekDir::Current) = 0;
 		virtual bool is_open() const                                                               = 0;
 
+		// Whole content of the reader in memory, or empty span if the reader is not memory based
+		virtual Span<const byte> view();
+
 
 		template<typename... T>
 		FORCE_INLINE bool read_primitives(T&... value)
@@ -184,6 +191,11 @@ namespace Engine
 		{
 			return true;
 		}
+
+		Span<const byte> view() override
+		{
+			return Span<const byte>(reinterpret_cast<const byte*>(m_buffer->data()), m_buffer->size() * sizeof(T));
+		}
 	};
 
 }// namespace Engine
@@ -1,8 +1,78 @@
+#pragma once
+#include <Core/buffer_manager.hpp>
 #include <Core/engine_types.hpp>
 #include <Core/etl/vector.hpp>
+#include <Core/thread_manager.hpp>
 
 namespace Engine::Compressor
 {
-	ENGINE_EXPORT void compress(const Buffer& src, Buffer& dst);
+	// Compressed data is split into independent blocks, which are compressed and decompressed in parallel
+	static constexpr inline uint32_t magic      = 0x4B4C5254;// TRLK
+	static constexpr inline uint32_t version    = 1;
+	static constexpr inline uint32_t block_size = 256 * 1024;
+
+	enum class Codec : uint32_t
+	{
+		LZ4   = 0,// Fast compression, used by development builds
+		LZ4HC = 1,// Slow compression with better ratio, uses Settings::lz4_compression_level
+	};
+
+	struct Header {
+		uint32_t magic;
+		uint32_t version;
+		Codec codec;
+		uint32_t block_size;
+		uint64_t original_size;
+		uint64_t blocks_count;
+	};
+
+	// Blocks which cannot be compressed are stored as is, so compressed_size == original_size means raw data
+	struct Block {
+		uint32_t compressed_size;
+		uint32_t original_size;
+		uint64_t checksum;// Hash of the stored data
+	};
+
+	// Reader which decompresses blocks on demand while the archive reads them. The next block is decompressed on the
+	// worker thread in advance. Compressed data must be alive while the reader is used
+	class ENGINE_EXPORT StreamReader : public BufferReader
+	{
+	private:
+		Span<const byte> m_data;
+		Header m_header = {};
+		Vector<Block> m_blocks;
+		Vector<uint64_t> m_offsets;
+
+		Buffer m_block;
+		Buffer m_next_block;
+		JobHandle m_next_job;
+		size_t m_block_index      = ~static_cast<size_t>(0);
+		size_t m_next_block_index = ~static_cast<size_t>(0);
+		bool m_next_block_status  = false;
+
+		ReadPos m_position = 0;
+		bool m_is_open     = false;
+
+		bool load_block(size_t index);
+		void prefetch_block(size_t index);
+
+	public:
+		StreamReader(Span<const byte> compressed);
+		delete_copy_constructors(StreamReader);
+		~StreamReader();
+
+		using BufferReader::position;
+		bool read(byte* data, size_t size) override;
+		ReadPos position() override;
+		StreamReader& offset(PosOffset offset, BufferSeekDir dir = BufferSeekDir::Current) override;
+		bool is_open() const override;
+	};
+
+	// Fast codec for development builds, high compression codec for shipping builds
+	ENGINE_EXPORT Codec default_codec();
+
+	ENGINE_EXPORT void compress(const Buffer& src, Buffer& dst, Codec codec = default_codec());
+	ENGINE_EXPORT void compress(const byte* src, size_t size, Buffer& dst, Codec codec = default_codec());
 	ENGINE_EXPORT void decompress(const Buffer& src, Buffer& dst);
+	ENGINE_EXPORT void decompress(const byte* src, size_t size, Buffer& dst);
 }// namespace Engine::Compressor
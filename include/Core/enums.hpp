@@ -62,6 +62,7 @@ namespace Engine
 		Bitangent    = 5,
 		BlendWeight  = 6,
 		BlendIndices = 7,
+		Transform    = 8,// Column of the instance transform, semantic index is the column index
 	};
 
 	enum class VertexBufferElementType : EnumerateType
@@ -461,6 +462,13 @@ namespace Engine
 		ReleaseRefs      = 13,
 	};
 
+	enum class LoadPriority : EnumerateType
+	{
+		Low    = 0,
+		Normal = 1,
+		High   = 2,
+	};
+
 	enum class ScriptTypeModifiers : EnumerateType
 	{
 		None     = 0,
@@ -1,6 +1,7 @@
 #pragma once
 #include <Core/export.hpp>
 #include <limits>
+#include <new>
 #include <utility>
 
 namespace Engine
@@ -83,6 +84,50 @@ namespace Engine
 		return false;
 	}
 
+	// Allocator which respects the alignment of over-aligned types
+	template<typename T>
+	struct AlignedAllocator : AllocatorBase {
+		using value_type      = T;
+		using pointer         = value_type*;
+		using const_pointer   = const value_type*;
+		using reference       = value_type&;
+		using const_reference = const value_type&;
+		using size_type       = std::size_t;
+		using difference_type = std::ptrdiff_t;
+
+		template<typename U>
+		struct rebind {
+			using other = AlignedAllocator<U>;
+		};
+
+		AlignedAllocator() = default;
+
+		template<typename U>
+		AlignedAllocator(const AlignedAllocator<U>&)
+		{}
+
+		pointer allocate(size_type size)
+		{
+			return static_cast<pointer>(::operator new(size * sizeof(T), std::align_val_t(alignof(T))));
+		}
+
+		void deallocate(pointer ptr, size_type size) noexcept
+		{
+			::operator delete(ptr, size * sizeof(T), std::align_val_t(alignof(T)));
+		}
+	};
+
+	template<typename T, typename U>
+	inline bool operator==(const AlignedAllocator<T>&, const AlignedAllocator<U>&)
+	{
+		return true;
+	}
+
+	template<typename T, typename U>
+	inline bool operator!=(const AlignedAllocator<T>&, const AlignedAllocator<U>&)
+	{
+		return false;
+	}
 
 	struct ENGINE_EXPORT BlockAllocatorBase : AllocatorBase {
 	public:
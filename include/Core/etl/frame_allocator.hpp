@@ -0,0 +1,133 @@
+#pragma once
+#include <Core/definitions.hpp>
+#include <Core/etl/allocator.hpp>
+#include <Core/etl/atomic.hpp>
+#include <Core/etl/vector.hpp>
+#include <cstddef>
+
+namespace Engine
+{
+	// Thread local arena for the memory which lives until the end of the render frame. Memory is allocated from the chain of
+	// pages by bumping the pointer, so addresses of allocated objects are stable until the arena is reset. Destructors of
+	// the objects allocated from the arena are not called automatically
+	class ENGINE_EXPORT FrameArena final
+	{
+	public:
+		using size_type = std::size_t;
+
+		static constexpr inline size_type page_size         = 256 * 1024;
+		static constexpr inline size_type default_alignment = alignof(std::max_align_t);
+
+		struct Statistics {
+			size_type allocations = 0;
+			size_type peak_usage  = 0;
+		};
+
+	private:
+		struct Page {
+			Page* next;
+			size_type size;
+		};
+
+		Page* m_first_page      = nullptr;
+		Page* m_current_page    = nullptr;
+		unsigned char* m_cursor = nullptr;
+		unsigned char* m_end    = nullptr;
+
+		size_type m_used_in_pages = 0;
+		size_type m_capacity      = 0;
+
+		// Written only by the owning thread, atomics allow other threads to read statistics
+		Atomic<size_type> m_allocations = 0;
+		Atomic<size_type> m_peak_usage  = 0;
+		Atomic<size_type> m_frame       = 0;
+
+		FrameArena();
+		~FrameArena();
+
+		void next_page(size_type size, size_type align);
+
+	public:
+		delete_copy_constructors(FrameArena);
+
+		// Arena of the calling thread. Arena is reset lazily on the first access after the end of the frame
+		static FrameArena& instance();
+
+		// Marks the end of the render frame. All memory allocated from the arenas in this frame becomes invalid
+		static void end_frame();
+
+		// Sums the statistics of the arenas of all threads. Allocations are counted only for the current frame
+		static Statistics statistics();
+
+		void* allocate(size_type size, size_type align = default_alignment);
+
+		// Only the last allocation can be returned to the arena, other deallocations are ignored
+		FrameArena& deallocate(void* ptr, size_type size);
+		FrameArena& reset();
+
+		template<typename Type, typename... Args>
+		FORCE_INLINE Type* create(Args&&... args)
+		{
+			return new (allocate(sizeof(Type), alignof(Type))) Type(std::forward<Args>(args)...);
+		}
+
+		template<typename Type>
+		FORCE_INLINE Type* allocate_array(size_type count)
+		{
+			return reinterpret_cast<Type*>(allocate(sizeof(Type) * count, alignof(Type)));
+		}
+
+		size_type used() const;
+		size_type capacity() const;
+		size_type allocations_count() const;
+		size_type peak_usage() const;
+	};
+
+	template<typename T>
+	struct FrameAllocator : AllocatorBase {
+		using value_type      = T;
+		using pointer         = value_type*;
+		using const_pointer   = const value_type*;
+		using reference       = value_type&;
+		using const_reference = const value_type&;
+		using size_type       = std::size_t;
+		using difference_type = std::ptrdiff_t;
+
+		template<typename U>
+		struct rebind {
+			using other = FrameAllocator<U>;
+		};
+
+		FrameAllocator() = default;
+
+		template<typename U>
+		FrameAllocator(const FrameAllocator<U>&)
+		{}
+
+		pointer allocate(size_type size)
+		{
+			return FrameArena::instance().allocate_array<T>(size);
+		}
+
+		void deallocate(pointer ptr, size_type size) noexcept
+		{
+			FrameArena::instance().deallocate(ptr, size * sizeof(T));
+		}
+	};
+
+	template<typename T, typename U>
+	inline bool operator==(const FrameAllocator<T>&, const FrameAllocator<U>&)
+	{
+		return true;
+	}
+
+	template<typename T, typename U>
+	inline bool operator!=(const FrameAllocator<T>&, const FrameAllocator<U>&)
+	{
+		return false;
+	}
+
+	// Vector for the transient data of the render frame. Must not outlive the frame in which it was filled
+	template<typename Type>
+	using FrameVector = Containers::Vector<Type, FrameAllocator<Type>>;
+}// namespace Engine
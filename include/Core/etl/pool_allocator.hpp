@@ -0,0 +1,39 @@
+#pragma once
+#include <Core/definitions.hpp>
+#include <Core/export.hpp>
+#include <cstddef>
+
+namespace Engine
+{
+	// Allocator of the small blocks. Blocks are grouped into size classes and allocated from the slabs, so objects of the
+	// same size are placed next to each other. Each thread keeps a small cache of free blocks for each size class, so most
+	// allocations do not touch the shared pools
+	class ENGINE_EXPORT PoolAllocator final
+	{
+	public:
+		using size_type = std::size_t;
+
+		static constexpr inline size_type granularity       = 16;
+		static constexpr inline size_type max_block_size    = 1024;
+		static constexpr inline size_type size_classes      = max_block_size / granularity;
+		static constexpr inline size_type slab_size         = 64 * 1024;
+		static constexpr inline size_type thread_cache_size = 64;
+
+		struct Statistics {
+			size_type block_size;
+			size_type allocated_blocks;
+			size_type slabs_count;
+		};
+
+		// Blocks larger than max_block_size are allocated from the general heap
+		static void* allocate(size_type size);
+		static void deallocate(void* ptr, size_type size);
+
+		static FORCE_INLINE constexpr size_type size_class_of(size_type size)
+		{
+			return size == 0 ? 0 : (size - 1) / granularity;
+		}
+
+		static Statistics statistics(size_type size_class);
+	};
+}// namespace Engine
@@ -64,6 +64,7 @@ namespace Engine
 		ReadPos position() override;
 		FileReader& offset(PosOffset offset, BufferSeekDir dir = BufferSeekDir::Current) override;
 		bool is_open() const override;
+		Span<const byte> view() override;
 
 		String read_string(size_t len = -1);
 		Buffer read_buffer(size_t len = -1);
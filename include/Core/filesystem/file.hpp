@@ -1,5 +1,6 @@
 #pragma once
 #include <Core/enums.hpp>
+#include <Core/etl/span.hpp>
 #include <Core/filesystem/path.hpp>
 #include <Core/flags.hpp>
 
@@ -26,6 +27,9 @@ namespace Engine::VFS
 		virtual size_t read(byte* buffer, size_t size)                          = 0;
 		virtual size_t write(const byte* buffer, size_t size)                   = 0;
 
+		// Content of the file in memory, or empty span if the file is not mapped
+		virtual Span<const byte> view() const;
+
 		template<typename T>
 		bool read(T& value)
 		{
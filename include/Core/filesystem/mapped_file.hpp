@@ -0,0 +1,61 @@
+#pragma once
+#include <Core/etl/smart_ptr.hpp>
+#include <Core/etl/span.hpp>
+#include <Core/filesystem/file.hpp>
+
+namespace Engine::VFS
+{
+	// Read-only memory mapping of the whole native file
+	class ENGINE_EXPORT MappedFile final
+	{
+	private:
+		const byte* m_data = nullptr;
+		size_t m_size      = 0;
+		bool m_is_open     = false;
+
+#if PLATFORM_WINDOWS
+		void* m_file    = nullptr;
+		void* m_mapping = nullptr;
+#endif
+
+	public:
+		MappedFile();
+		MappedFile(const Path& native_path);
+		delete_copy_constructors(MappedFile);
+		~MappedFile();
+
+		bool open(const Path& native_path);
+		MappedFile& close();
+
+		bool is_open() const;
+		const byte* data() const;
+		size_t size() const;
+		Span<const byte> span(size_t offset, size_t size) const;
+	};
+
+	// File which reads the range of the mapped file. Reading copies data from the mapped pages, view() returns them directly
+	class ENGINE_EXPORT MappedFileView final : public File
+	{
+	private:
+		Path m_path;
+		SharedPtr<MappedFile> m_mapping;
+		Span<const byte> m_view;
+		FilePosition m_position = 0;
+
+	public:
+		MappedFileView(const Path& path, const SharedPtr<MappedFile>& mapping, size_t offset, size_t size);
+		delete_copy_constructors(MappedFileView);
+
+		const Path& path() const override;
+		bool is_read_only() const override;
+		void close() override;
+		bool is_open() const override;
+		FilePosition read_position(FileOffset offset, FileSeekDir dir) override;
+		FilePosition read_position() override;
+		FilePosition write_position(FileOffset offset, FileSeekDir dir) override;
+		FilePosition write_position() override;
+		size_t read(byte* buffer, size_t size) override;
+		size_t write(const byte* buffer, size_t size) override;
+		Span<const byte> view() const override;
+	};
+}// namespace Engine::VFS
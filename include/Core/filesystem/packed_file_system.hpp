@@ -0,0 +1,83 @@
+#pragma once
+#include <Core/etl/smart_ptr.hpp>
+#include <Core/filesystem/filesystem.hpp>
+
+namespace Engine::VFS
+{
+	// Read-only file system stored in the single pack file. Table of contents is sorted by path, data of each entry is
+	// aligned to 64 KB and can be compressed with LZ4. Entries can store hash of the content, which is checked on open
+	class MappedFile;
+
+	class ENGINE_EXPORT PackedFileSystem : public FileSystem
+	{
+	public:
+		static constexpr inline uint32_t magic        = 0x4B505254;// TRPK
+		static constexpr inline uint32_t version      = 1;
+		static constexpr inline uint64_t alignment    = 64 * 1024;
+		static constexpr inline const char* extension = ".pak";
+
+		enum EntryFlags : uint32_t
+		{
+			Compressed = 1,
+			Hashed     = 2,
+		};
+
+		struct Header {
+			uint32_t magic;
+			uint32_t version;
+			uint32_t entries_count;
+			uint32_t flags;
+			uint64_t toc_offset;
+			uint64_t toc_size;
+		};
+
+		struct Entry {
+			Path path;
+			uint64_t offset;
+			uint64_t size;// Size of the data in the pack file
+			uint64_t original_size;
+			uint64_t hash;
+			uint32_t flags;
+		};
+
+	private:
+		Path m_path;
+		Vector<Entry> m_entries;
+		Vector<Path> m_directories;
+		SharedPtr<MappedFile> m_mapping;
+
+		const Entry* find_entry(const Path& path) const;
+		bool is_directory_entry(const Path& path) const;
+		DirectoryIteratorInterface* create_iterator(const Path& path, bool recursive);
+
+	protected:
+		DirectoryIteratorInterface* create_directory_iterator(const Path& path) override;
+		DirectoryIteratorInterface* create_recursive_directory_iterator(const Path& path) override;
+
+	public:
+		delete_copy_constructors(PackedFileSystem);
+
+		// Path to the pack file in the native file system
+		PackedFileSystem(const Path& pack);
+
+		// Packs all files of the native folder into the pack file. Entries are compressed only if it reduces their size
+		static bool pack(const Path& native_folder, const Path& output, bool compress = true);
+
+		bool is_valid() const;
+		const Vector<Entry>& entries() const;
+
+		const Path& path() const override;
+		Path native_path(const Path& path) const override;
+
+		bool is_read_only() const override;
+		File* open(const Path& path, Flags<FileOpenMode> mode) override;
+		bool create_dir(const Path& path) override;
+		bool remove(const Path& path) override;
+		bool copy(const Path& src, const Path& dest) override;
+		bool rename(const Path& src, const Path& dest) override;
+		bool is_file_exist(const Path& path) const override;
+		bool is_file(const Path& file) const override;
+		bool is_dir(const Path& dir) const override;
+		Type type() const override;
+	};
+}// namespace Engine::VFS
@@ -52,6 +52,7 @@ namespace Engine::VFS
 		Path native_path(const Path& path) const override;
 		FileSystem* filesystem_of(const Path& path) const;
 		FileSystem::Type filesystem_type_of(const Path& path) const;
+		// Creates the pack file in the native file system, which can be mounted as PackedFileSystem
 		bool pack_native_folder(const Path& native, const Path& virtual_fs, const StringView& password = {}) const;
 		Vector<String> mount_points() const;
 		const FileSystemMap& filesystems() const;
@@ -1,5 +1,6 @@
 #pragma once
 #include <Core/engine_types.hpp>
+#include <type_traits>
 
 namespace Engine
 {
@@ -87,6 +88,22 @@ namespace Engine
 			return *this;
 		}
 
+		// Removes mask and returns true if any bit of the mask was set before. Operation is atomic for atomic value type
+		FORCE_INLINE bool exchange_remove(Flags mask)
+		{
+			if constexpr (std::is_integral_v<ValueType>)
+			{
+				const bool result = (m_flags & mask.m_flags) != 0;
+				m_flags &= ~mask.m_flags;
+				return result;
+			}
+			else
+			{
+				const BitMask bits = mask.m_flags;
+				return (m_flags.fetch_and(~bits) & bits) != 0;
+			}
+		}
+
 		FORCE_INLINE Flags& toggle(Flags mask)
 		{
 			m_flags ^= mask.m_flags;
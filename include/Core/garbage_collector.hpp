@@ -14,22 +14,28 @@ namespace Engine
 	class ENGINE_EXPORT GarbageCollector final
 	{
 	public:
+		// Called from the logic thread before the scan of roots, callbacks can clear IsUnreachable flag to keep the object
 		ENGINE_EXPORT static CallBacks<void(Object*)> on_unreachable_check;
 		ENGINE_EXPORT static CallBacks<void(Object*)> on_destroy;
 
 		ENGINE_EXPORT static void destroy(Object* object);
 		ENGINE_EXPORT static void update(float dt);
 
+		// Must be called when the reference to the object is stored while the collection cycle is active, otherwise
+		// the object can be collected. Pointer<T> calls it automatically
+		ENGINE_EXPORT static void write_barrier(Object* object);
+
+		// Runs root scan and mark phase of the new cycle without time limit. Returns count of traced objects
+		ENGINE_EXPORT static size_t mark_all();
+
 		friend class EngineLoop;
 		friend class Class;
 		friend class Refl::Class;
+		friend class Object;
 
 	private:
-		ENGINE_EXPORT static void submit_current_stage();
-		ENGINE_EXPORT static bool process_objects(void (*callback)(Object* object));
-		ENGINE_EXPORT static void mark_unreachable(float dt);
-		ENGINE_EXPORT static void collect_garbage(float dt);
-		ENGINE_EXPORT static void destroy_garbage(float dt);
+		ENGINE_EXPORT static void on_object_created(Object* object);
+		ENGINE_EXPORT static void wait_for_sweep();
 		ENGINE_EXPORT static void destroy_recursive(Object* object, bool destroy_owner_if_exist = false);
 		ENGINE_EXPORT static void destroy_internal(Object* object);
 
@@ -68,6 +68,7 @@ namespace Engine
 		Name& operator=(const String& name);
 		Name& operator=(const StringView& name);
 
+		// Returns the name only if it was already created, the table is not modified
 		static Name find_name(const StringView& name);
 
 		bool is_valid() const;
@@ -93,7 +94,8 @@ namespace Engine
 		operator const String&() const;
 		operator StringView() const;
 
-		static const Vector<Name::Entry>& entries();
+		// Count of reserved entries. The last entries can still be under construction by other threads
+		static size_t entries_count();
 
 		FORCE_INLINE bool operator==(const Name& name) const
 		{
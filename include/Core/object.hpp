@@ -13,9 +13,26 @@ namespace Engine
 	class Package;
 	class Object;
 	class Path;
+	class LoadHandle;
 
 	ENGINE_EXPORT const char* operator""_localized(const char* line, size_t len);
 
+	// Handle of the object in the registry. Slot of the destroyed object gets new generation, so stale handles are detected
+	struct ObjectHandle {
+		uint32_t index      = ~static_cast<uint32_t>(0);
+		uint32_t generation = 0;
+
+		FORCE_INLINE bool operator==(const ObjectHandle& other) const
+		{
+			return index == other.index && generation == other.generation;
+		}
+
+		FORCE_INLINE bool operator!=(const ObjectHandle& other) const
+		{
+			return !(*this == other);
+		}
+	};
+
 	// Head of all classes in the Engine
 	class ENGINE_EXPORT Object : private asIScriptObject
 	{
@@ -63,12 +80,15 @@ namespace Engine
 		mutable Atomic<Counter> m_references;
 		Name m_name;
 		mutable Index m_instance_index;
+		mutable Index m_class_instance_index;
+		mutable ObjectHandle m_handle;
 
 	protected:
 		static class Refl::Class* m_static_class;
 
 	public:
-		mutable Flags<Object::Flag> flags;
+		// Flags are atomic, because garbage collector marks objects from the worker threads
+		mutable Flags<Object::Flag, Atomic<BitMask>> flags;
 
 	private:
 		// Setup object info
@@ -76,6 +96,12 @@ namespace Engine
 		static void reset_next_object_info();
 
 		static void create_default_package();
+		static Path asset_path_of(StringView fullname);
+		static bool read_asset_data(class BufferReader* reader, Buffer& raw_data, Vector<String>* dependencies = nullptr);
+		static Object* load_object_from_data(StringView fullname, const Buffer& raw_data);
+		static Object* load_object_from_data(StringView fullname, class BufferReader* raw_reader);
+
+		const Object& add_to_instances_array();
 		const Object& remove_from_instances_array() const;
 
 		template<typename T>
@@ -136,7 +162,13 @@ namespace Engine
 		static String object_name_of(const StringView& name);
 		static StringView package_name_sv_of(const StringView& name);
 		static StringView object_name_sv_of(const StringView& name);
+		// Dense array of all objects. Destroyed object is replaced by the last one, so order and indices can change
 		static const Vector<Object*>& all_objects();
+		static Object* object_of(const ObjectHandle& handle);
+
+		// Instances of the class and of all derived classes, defined in Core/reflection/class.hpp
+		template<typename Type>
+		static Vector<Type*> instances_of();
 		static Package* root_package();
 		static bool static_validate_object_name(StringView name, String* msg = nullptr);
 
@@ -160,6 +192,7 @@ namespace Engine
 		size_t remove_reference() const;
 		bool is_noname() const;
 		Index instance_index() const;
+		const ObjectHandle& handle() const;
 		virtual bool serialize(Archive& archive);
 		Path filepath() const;
 		bool is_editable() const;
@@ -169,11 +202,24 @@ namespace Engine
 		bool is_dirty() const;
 
 		virtual bool save(class BufferWriter* writer = nullptr, Flags<SerializationFlags> flags = {});
+
+		// Serializes the object into the uncompressed asset data. Must be called from the logic thread
+		bool save_snapshot(Buffer& raw_data, Vector<String>& dependencies, Flags<SerializationFlags> flags = {});
+
+		// Compresses the snapshot and writes it with the asset header. Can be called from any thread
+		ENGINE_EXPORT static bool write_snapshot(class BufferWriter* writer, const Buffer& raw_data,
+		                                         const Vector<String>& dependencies);
+
+		// Replaces the asset file atomically. File is not rewritten if the content hash in its header is the same
+		ENGINE_EXPORT static bool write_snapshot(StringView fullname, const Buffer& raw_data, const Vector<String>& dependencies);
 		ENGINE_EXPORT static Object* load_object(StringView fullname, class BufferReader* reader,
 		                                         Flags<SerializationFlags> flags = {});
 		ENGINE_EXPORT static Object* load_object(StringView fullname, Flags<SerializationFlags> flags = {});
 		ENGINE_EXPORT static Object* load_object_from_file(const Path& path, Flags<SerializationFlags> flags = {});
 
+		// Reads and decompresses the asset on the worker threads, the object is created on the logic thread by AssetLoader
+		ENGINE_EXPORT static LoadHandle load_object_async(StringView fullname, LoadPriority priority = LoadPriority::Normal);
+
 
 		virtual Object& preload();
 		virtual Object& postload();
@@ -184,7 +230,10 @@ namespace Engine
 		Object* owner() const;
 		bool owner(Object* new_owner);
 
+		// Copies are serialized in memory without compression and names of the referenced objects. References to the
+		// composite subobjects of the source are remapped to the subobjects of the copy
 		static ENGINE_EXPORT Object* copy_from(Object* src);
+		static ENGINE_EXPORT Vector<Object*> clone_n(Object* src, size_t count);
 
 		static Object* static_new_instance(Refl::Class* object_class, StringView name = "", Object* owner = nullptr);
 		static Object* static_new_placement_instance(void* place, Refl::Class* object_class, StringView name = "",
@@ -344,6 +393,8 @@ namespace Engine
 		friend class Archive;
 		friend class MemoryManager;
 		friend class GarbageCollector;
+		friend class AssetLoader;
+		friend class AssetRegistry;
 		friend class Refl::Class;
 	};
 
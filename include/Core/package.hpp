@@ -2,6 +2,7 @@
 
 #include <Core/etl/object_tree_node.hpp>
 #include <Core/object.hpp>
+#include <Core/thread_manager.hpp>
 
 namespace Engine
 {
@@ -26,7 +27,19 @@ namespace Engine
 		const Vector<Object*>& objects() const;
 		bool contains_object(const Object* object) const;
 		bool contains_object(const StringView& name) const;
+
+		// Without writer only modified objects and objects without asset file are saved. Objects are serialized on the
+		// calling thread, compression and writing of the files is done in parallel
 		bool save(BufferWriter* writer = nullptr, Flags<SerializationFlags> flags = {}) override;
+
+		// Same as incremental save, but files are written by the background job. Must be called from the logic thread
+		JobHandle save_async(Flags<SerializationFlags> flags = {});
+
+		// Saves one object in the same way as save_async. Packages are saved with all their objects
+		static JobHandle save_object_async(Object* object, Flags<SerializationFlags> flags = {});
+
+		// Waits until all files of the background saves are written
+		static void wait_for_async_saves();
 		friend class Object;
 	};
 }// namespace Engine
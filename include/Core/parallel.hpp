@@ -0,0 +1,239 @@
+#pragma once
+#include <Core/thread_manager.hpp>
+#include <algorithm>
+#include <memory>
+#include <type_traits>
+
+namespace Engine
+{
+	namespace Parallel
+	{
+		static constexpr inline size_t cache_line_size   = 64;
+		static constexpr inline size_t min_grain_size    = 64;
+		static constexpr inline size_t chunks_per_thread = 4;
+
+		FORCE_INLINE size_t threads_count()
+		{
+			// Workers and thread which started the parallel algorithm
+			return ThreadManager::instance()->threads_count() + 1;
+		}
+
+		FORCE_INLINE size_t grain_size(size_t count, size_t grain = 0)
+		{
+			if (grain == 0)
+			{
+				grain = count / (threads_count() * chunks_per_thread);
+				grain = glm::max(grain, min_grain_size);
+			}
+			return grain;
+		}
+
+		// Executes callable(chunk_begin, chunk_end, slot) for each chunk. Chunks are distributed dynamically between the
+		// calling thread and the workers, each of them gets its own slot in range [0, threads_count())
+		template<typename Callable>
+		void execute_chunks(size_t begin, size_t end, size_t grain, Callable&& callable)
+		{
+			if (begin >= end)
+				return;
+
+			const size_t count        = end - begin;
+			grain                     = grain_size(count, grain);
+			const size_t chunks_count = (count + grain - 1) / grain;
+
+			if (chunks_count == 1)
+			{
+				callable(begin, end, 0);
+				return;
+			}
+
+			// Helpers can be started after all chunks are finished, so the state is shared with them. Callable is used only
+			// while some chunk is not finished, and the calling thread doesn't return before that
+			struct State {
+				Atomic<size_t> next_chunk     = 0;
+				Atomic<size_t> finished_count = 0;
+			};
+
+			auto state  = std::make_shared<State>();
+			auto worker = [state, &callable, begin, end, grain, chunks_count](size_t slot) {
+				size_t chunk;
+				while ((chunk = state->next_chunk.fetch_add(1)) < chunks_count)
+				{
+					const size_t chunk_begin = begin + chunk * grain;
+					callable(chunk_begin, glm::min(chunk_begin + grain, end), slot);
+
+					if (state->finished_count.fetch_add(1) + 1 == chunks_count)
+						state->finished_count.notify_all();
+				}
+			};
+
+			ThreadManager* manager     = ThreadManager::instance();
+			const size_t helpers_count = glm::min(manager->threads_count(), chunks_count - 1);
+
+			for (size_t i = 1; i <= helpers_count; ++i)
+			{
+				manager->call_function([worker, i]() { worker(i); });
+			}
+
+			worker(0);
+
+			// Remaining chunks are already taken by running helpers, helpers which are still queued will find no chunks
+			size_t finished;
+			while ((finished = state->finished_count.load()) < chunks_count)
+			{
+				state->finished_count.wait(finished);
+			}
+		}
+	}// namespace Parallel
+
+	// Storage with one instance of Type for each participant of parallel algorithm. Slot index is passed to the body of
+	// parallel_for, so threads which are not workers never share a slot
+	template<typename Type>
+	class ParallelScratch
+	{
+	private:
+		// Each slot starts a new cache line, so values of different threads never share one
+		struct alignas(Parallel::cache_line_size) Slot {
+			Type value;
+		};
+
+		Containers::Vector<Slot, AlignedAllocator<Slot>> m_slots;
+
+	public:
+		ParallelScratch() : m_slots(Parallel::threads_count())
+		{}
+
+		ParallelScratch(const Type& value) : m_slots(Parallel::threads_count(), Slot{value})
+		{}
+
+		FORCE_INLINE Type& operator[](size_t slot)
+		{
+			return m_slots[slot].value;
+		}
+
+		template<typename Callable>
+		ParallelScratch& for_each(Callable&& callable)
+		{
+			for (auto& slot : m_slots)
+			{
+				callable(slot.value);
+			}
+			return *this;
+		}
+
+		FORCE_INLINE size_t size() const
+		{
+			return m_slots.size();
+		}
+	};
+
+	// Callable must accept (size_t index), (size_t begin, size_t end) or (size_t begin, size_t end, size_t slot), where slot
+	// is the index of ParallelScratch slot owned by the thread which executes the chunk
+	template<typename Callable>
+	void parallel_for(size_t begin, size_t end, size_t grain, Callable&& callable)
+	{
+		if constexpr (std::is_invocable_v<Callable, size_t, size_t, size_t>)
+		{
+			Parallel::execute_chunks(begin, end, grain, callable);
+		}
+		else if constexpr (std::is_invocable_v<Callable, size_t, size_t>)
+		{
+			Parallel::execute_chunks(begin, end, grain,
+			                         [&callable](size_t chunk_begin, size_t chunk_end, size_t) { callable(chunk_begin, chunk_end); });
+		}
+		else
+		{
+			Parallel::execute_chunks(begin, end, grain, [&callable](size_t chunk_begin, size_t chunk_end, size_t) {
+				for (size_t i = chunk_begin; i < chunk_end; ++i)
+				{
+					callable(i);
+				}
+			});
+		}
+	}
+
+	template<typename Callable>
+	FORCE_INLINE void parallel_for(size_t count, size_t grain, Callable&& callable)
+	{
+		parallel_for(0, count, grain, std::forward<Callable>(callable));
+	}
+
+	template<typename Callable>
+	FORCE_INLINE void parallel_for(size_t count, Callable&& callable)
+	{
+		parallel_for(0, count, 0, std::forward<Callable>(callable));
+	}
+
+	// map(size_t begin, size_t end, Type value) -> Type accumulates chunk into value, reduce(Type, Type) -> Type combines
+	// results of chunks. Chunks are combined in order, so result is deterministic for associative reduce
+	template<typename Type, typename MapCallable, typename ReduceCallable>
+	Type parallel_reduce(size_t begin, size_t end, size_t grain, const Type& identity, MapCallable&& map,
+	                     ReduceCallable&& reduce)
+	{
+		if (begin >= end)
+			return identity;
+
+		grain = Parallel::grain_size(end - begin, grain);
+
+		const size_t chunks_count = (end - begin + grain - 1) / grain;
+		Vector<Type> results(chunks_count, identity);
+
+		Parallel::execute_chunks(begin, end, grain, [&](size_t chunk_begin, size_t chunk_end, size_t) {
+			Type& result = results[(chunk_begin - begin) / grain];
+			result       = map(chunk_begin, chunk_end, result);
+		});
+
+		Type result = identity;
+		for (Type& value : results)
+		{
+			result = reduce(result, value);
+		}
+		return result;
+	}
+
+	template<typename Type, typename MapCallable, typename ReduceCallable>
+	FORCE_INLINE Type parallel_reduce(size_t count, const Type& identity, MapCallable&& map, ReduceCallable&& reduce)
+	{
+		return parallel_reduce(0, count, 0, identity, std::forward<MapCallable>(map), std::forward<ReduceCallable>(reduce));
+	}
+
+	// Sorts chunks in parallel and merges them pairwise
+	template<typename Iterator, typename Compare>
+	void parallel_sort(Iterator begin, Iterator end, Compare&& compare, size_t grain = 0)
+	{
+		const size_t count = static_cast<size_t>(std::distance(begin, end));
+
+		if (count < 2)
+			return;
+
+		grain                     = Parallel::grain_size(count, grain == 0 ? count / Parallel::threads_count() : grain);
+		const size_t chunks_count = (count + grain - 1) / grain;
+
+		parallel_for(chunks_count, 1, [&](size_t chunk) {
+			const size_t chunk_begin = chunk * grain;
+			const size_t chunk_end   = glm::min(chunk_begin + grain, count);
+			std::sort(begin + chunk_begin, begin + chunk_end, compare);
+		});
+
+		for (size_t width = grain; width < count; width *= 2)
+		{
+			const size_t merges_count = (count + 2 * width - 1) / (2 * width);
+
+			parallel_for(merges_count, 1, [&](size_t merge) {
+				const size_t merge_begin = merge * 2 * width;
+				const size_t merge_mid   = glm::min(merge_begin + width, count);
+				const size_t merge_end   = glm::min(merge_begin + 2 * width, count);
+
+				if (merge_mid < merge_end)
+				{
+					std::inplace_merge(begin + merge_begin, begin + merge_mid, begin + merge_end, compare);
+				}
+			});
+		}
+	}
+
+	template<typename Iterator>
+	FORCE_INLINE void parallel_sort(Iterator begin, Iterator end)
+	{
+		parallel_sort(begin, end, std::less<>());
+	}
+}// namespace Engine
@@ -16,6 +16,8 @@ namespace Engine
 
 		private:
 			mutable Engine::Object* m_singletone_object;
+			Vector<Engine::Object*> m_instances;
+			Atomic<size_t> m_allocations_count = 0;
 
 		protected:
 			static bool is_script_class(Class* self);
@@ -43,6 +45,27 @@ namespace Engine
 			virtual Class& destroy_object(Engine::Object* object);
 			Engine::Object* singletone_instance() const;
 
+			// Number of objects of this exact class which were created since start and which are alive now
+			size_t allocations_count() const;
+			size_t instances_count() const;
+
+			// Alive instances of this exact class, instances of the derived classes are not included
+			const Vector<Engine::Object*>& instances() const;
+
+			template<typename Callable>
+			void for_each_instance(Callable&& callable) const
+			{
+				for (Engine::Object* object : m_instances)
+				{
+					callable(object);
+				}
+
+				for (Struct* derived : derived_structs())
+				{
+					static_cast<Class*>(derived)->for_each_instance(callable);
+				}
+			}
+
 			using Struct::is_a;
 			const ScriptTypeInfo& find_valid_script_type_info() const;
 			static const Vector<Class*>& asset_classes();
@@ -57,6 +80,7 @@ namespace Engine
 
 			friend class Engine::ScriptClassRegistrar;
 			friend class Engine::SingletoneBase;
+			friend class Engine::Object;
 		};
 
 		template<typename T>
@@ -144,4 +168,13 @@ namespace Engine
 			}
 		};
 	}// namespace Refl
+
+	template<typename Type>
+	Vector<Type*> Object::instances_of()
+	{
+		Vector<Type*> result;
+		Type::static_class_instance()->for_each_instance(
+		        [&result](Object* object) { result.push_back(static_cast<Type*>(object)); });
+		return result;
+	}
 }// namespace Engine
@@ -69,6 +69,10 @@ namespace Engine::Refl
 
 		virtual ~Object();
 
+		// Reflection objects are small and numerous, so they are allocated from the pools too
+		static void* operator new(size_t size);
+		static void operator delete(void* memory, size_t size) noexcept;
+
 	public:
 		using This     = Object;
 		using Super    = void;
@@ -1,4 +1,6 @@
 #pragma once
+#include <Core/etl/atomic.hpp>
+#include <Core/etl/critical_section.hpp>
 #include <Core/etl/set.hpp>
 #include <Core/etl/type_traits.hpp>
 #include <Core/flags.hpp>
@@ -40,12 +42,37 @@ namespace Engine::Refl
 		ScriptTypeInfo script_type_info;
 
 	private:
+		// Trivially copyable properties which are adjacent in memory are merged into one step and copied at once
+		struct SerializationStep {
+			Property* property;// First property of the step
+			size_t size;       // Size of the merged properties, or 0 if the property is serialized by itself
+			uint32_t first;
+			uint32_t count;
+		};
+
+		// Cached order of the serializable properties. Layout hash is stored in the archive, and if it matches on load,
+		// properties are read in this order without lookup by name
+		struct SerializationPlan {
+			Vector<Property*> properties;
+			Vector<SerializationStep> steps;
+			uint64_t layout_hash = 0;
+		};
+
 		Vector<Property*> m_properties;
 		Set<Struct*> m_derived_structs;
 		mutable Struct* m_parent = nullptr;
 
 		class Group* m_group = nullptr;
 
+		SerializationPlan m_serialization_plan;
+		Atomic<bool> m_is_serialization_plan_valid = false;
+		CriticalSection m_serialization_plan_section;
+
+		const SerializationPlan& serialization_plan(void* object);
+		bool save_properties(void* object, Archive& ar);
+		bool load_properties(void* object, Archive& ar);
+		bool load_tagged_properties(void* object, Archive& ar, size_t count);
+
 	protected:
 		void destroy_derived_structs();
 
@@ -1,8 +1,8 @@
 #pragma once
 #include <Core/engine_types.hpp>
+#include <Core/etl/atomic.hpp>
 #include <Core/etl/critical_section.hpp>
 #include <Core/exception.hpp>
-#include <Core/memory.hpp>
 #include <Core/task.hpp>
 #include <functional>
 #include <thread>
@@ -26,67 +26,62 @@ namespace Engine
 			}
 		};
 
-		struct SkipBytes : public Task<SkipBytes> {
-			int_t m_bytes;
-			SkipBytes(int_t bytes) : m_bytes(bytes)
-			{}
+		struct NoThreadContext {
+		};
 
-			size_t size() const override
+		struct alignas(16) CommandHeader {
+			enum State : uint32_t
 			{
-				return m_bytes;
-			}
+				Empty      = 0,
+				Ready      = 1,
+				EndOfChain = 2,
+			};
 
-			void execute() override
-			{}
+			Atomic<uint32_t> state;
+			uint32_t size;
 		};
 
-		struct NoThreadContext {
+		// Commands are stored in the chain of segments. Producers reserve space in the tail segment using an atomic counter,
+		// and when the segment is full, next segment is linked to it instead of waiting for the consumer
+		struct Segment {
+			Atomic<size_t> reserved;
+			Atomic<Segment*> next;
+			Segment* next_free;
+			size_t capacity;
+			byte* data;
 		};
 
-		static constexpr inline size_t m_buffer_size = 1024 * 1024 * 1;
-		static constexpr inline size_t m_align       = 16;
+		static constexpr inline size_t m_segment_size = 1024 * 256;
+		static constexpr inline size_t m_align        = alignof(CommandHeader);
 
-		alignas(m_align) byte m_buffer[m_buffer_size];
 		std::thread* m_thread = nullptr;
 
-		Atomic<byte*> m_read_pointer;
-		Atomic<byte*> m_write_pointer;
+		Segment* m_read_segment = nullptr;
+		size_t m_read_offset    = 0;
+		Atomic<Segment*> m_write_segment;
+
+		Segment* m_free_segments    = nullptr;
+		Segment* m_retired_segments = nullptr;
+		CriticalSection m_free_segments_section;
+
+		Atomic<size_t> m_active_producers     = 0;
+		Atomic<size_t> m_pending_commands     = 0;
+		Atomic<size_t> m_max_pending_commands = 0;
+		Atomic<size_t> m_stall_time           = 0;
+		Atomic<size_t> m_segments_count       = 0;
 
 		Atomic<bool> m_running = true;
 		Atomic<bool> m_is_busy = false;
 
-		std::atomic_flag m_exec_flag = ATOMIC_FLAG_INIT;
-		CriticalSection m_push_section;
-
 		Thread& execute_commands();
 		void thread_loop();
 
-		inline size_t free_size() const
-		{
-			byte* rp = m_read_pointer;
-			byte* wp = m_write_pointer;
-
-			if (rp < wp)
-			{
-				return (rp - m_buffer) + ((m_buffer + m_buffer_size) - wp);
-			}
-			else if (rp == wp)
-			{
-				return m_buffer_size;
-			}
-			else
-			{
-				return rp - wp;
-			}
-		}
-
-		FORCE_INLINE void wait_for_size(size_t size)
-		{
-			while (free_size() < size)
-			{
-				std::this_thread::yield();
-			}
-		}
+		Segment* allocate_segment(size_t min_size);
+		Segment* next_segment(Segment* segment, size_t min_size);
+		Thread& release_segment(Segment* segment);
+		Thread& release_retired_segments();
+		byte* reserve_command(size_t size);
+		Thread& submit_command(byte* command);
 
 		Thread(NoThreadContext ctx);
 
@@ -96,37 +91,23 @@ namespace Engine
 		bool is_busy() const;
 		Thread& wait();
 
+		// Number of submitted commands which are not executed yet
+		size_t queue_depth() const;
+		size_t max_queue_depth() const;
+
+		// Time in nanoseconds which producers spent on linking new segments
+		size_t producers_stall_time() const;
+		size_t segments_count() const;
+		Thread& reset_statistics();
+
 		template<typename CommandType, typename... Args>
 		inline Thread& create_task(Args&&... args)
 		{
-			m_push_section.lock();
-
-			size_t task_size = sizeof(CommandType);
-			byte* wp         = m_write_pointer;
-
-			if (wp + task_size > m_buffer + m_buffer_size)
-			{
-				wait_for_size(sizeof(SkipBytes));
-				new (wp) SkipBytes((m_buffer + m_buffer_size) - wp);
-				wp = m_buffer;
-			}
-
-			wait_for_size(task_size);
-
-			new (wp) CommandType(std::forward<Args>(args)...);
-			wp = align_memory(wp + task_size, m_align);
-
-			if (wp >= m_buffer + m_buffer_size)
-			{
-				wp = m_buffer;
-			}
-
-			m_write_pointer = wp;
-			m_exec_flag.test_and_set();
-			m_exec_flag.notify_all();
+			static_assert(alignof(CommandType) <= m_align, "Command alignment is not supported");
 
-			m_push_section.unlock();
-			return *this;
+			byte* command = reserve_command(sizeof(CommandType));
+			new (command) CommandType(std::forward<Args>(args)...);
+			return submit_command(command);
 		}
 
 		template<typename Function>
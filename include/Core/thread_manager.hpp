@@ -1,16 +1,47 @@
 #pragma once
+#include <Core/etl/atomic.hpp>
 #include <Core/etl/critical_section.hpp>
-#include <Core/etl/function.hpp>
 #include <Core/etl/vector.hpp>
-#include <Core/memory.hpp>
 #include <Core/task.hpp>
+#include <functional>
+#include <initializer_list>
 #include <thread>
 
 namespace Engine
 {
+	class ThreadManager;
+	struct Job;
+
+	class ENGINE_EXPORT JobHandle final
+	{
+	private:
+		Job* m_job = nullptr;
+
+		JobHandle(Job* job);
+
+	public:
+		JobHandle() = default;
+		JobHandle(const JobHandle& other);
+		JobHandle(JobHandle&& other);
+		JobHandle& operator=(const JobHandle& other);
+		JobHandle& operator=(JobHandle&& other);
+		~JobHandle();
+
+		bool is_valid() const;
+		bool is_finished() const;
+		JobHandle& reset();
+
+		FORCE_INLINE operator bool() const
+		{
+			return is_valid();
+		}
+
+		friend class ThreadManager;
+	};
+
 	class ENGINE_EXPORT ThreadManager final
 	{
-	protected:
+	private:
 		template<typename Func>
 		struct FunctionCaller : public Task<FunctionCaller<Func>> {
 			std::decay_t<Func> m_func;
@@ -25,118 +56,85 @@ namespace Engine
 			}
 		};
 
-		struct SkipBytes : public Task<SkipBytes> {
-			int_t m_bytes;
-			SkipBytes(int_t bytes) : m_bytes(bytes)
-			{}
+		struct WorkerQueue {
+			CriticalSection m_section;
+			Vector<Job*> m_jobs;
+			size_t m_head = 0;
+			size_t m_tail = 0;
 
-			size_t size() const override
-			{
-				return m_bytes;
-			}
-
-			void execute() override
-			{}
+			void push(Job* job);
+			Job* pop();
+			Job* steal();
 		};
 
-		static constexpr inline size_t m_buffer_size = 1024 * 1024 * 1;
-		static constexpr inline size_t m_align       = 16;
-
-		alignas(m_align) byte m_buffer[m_buffer_size];
 		Vector<std::thread> m_threads;
+		Vector<WorkerQueue*> m_queues;
 
-		Atomic<byte*> m_thread_read_pointer;
-		Atomic<byte*> m_read_pointer;
-		Atomic<byte*> m_write_pointer;
-
-		Atomic<bool> m_running = true;
-		Atomic<bool> m_has_tasks;
-		CriticalSection m_thread_section;
-		CriticalSection m_push_section;
-
-		void thread_loop();
-
-		inline size_t free_size() const
-		{
-			byte* rp = m_read_pointer;
-			byte* wp = m_write_pointer;
-
-			if (rp < wp)
-			{
-				return (rp - m_buffer) + ((m_buffer + m_buffer_size) - wp);
-			}
-			else if (rp == wp)
-			{
-				return m_buffer_size;
-			}
-			else
-			{
-				return rp - wp;
-			}
-		}
-
-		FORCE_INLINE void wait_for_size(size_t size)
-		{
-			while (free_size() < size)
-			{
-				std::this_thread::yield();
-			}
-		}
-
+		Atomic<size_t> m_wake_counter   = 0;
+		Atomic<size_t> m_next_queue     = 0;
+		Atomic<size_t> m_jobs_in_flight = 0;
+		Atomic<bool> m_running          = true;
 
 		ThreadManager();
 		~ThreadManager();
 
-		ThreadManager& resize(size_t threads_count);
+		void thread_loop(size_t index);
+		void stop_workers();
+		void start_workers(size_t threads_count);
+
+		Job* find_job(size_t queue_index);
+		ThreadManager& schedule(Job* job);
+		ThreadManager& execute(Job* job);
+		ThreadManager& finish(Job* job);
+		JobHandle submit(TaskInterface* task, const JobHandle* dependencies, size_t dependencies_count, const JobHandle& parent);
 
 	public:
 		static void destroy_manager();
 		static ThreadManager* instance();
+		static size_t default_threads_count();
+		static size_t worker_index();
 
-		template<typename CommandType, typename... Args>
-		inline ThreadManager& create_task(Args&&... args)
-		{
-			m_push_section.lock();
-
-			size_t task_size = sizeof(CommandType);
-			byte* wp         = m_write_pointer;
-
-			if (wp + task_size > m_buffer + m_buffer_size)
-			{
-				wait_for_size(sizeof(SkipBytes));
-				new (wp) SkipBytes((m_buffer + m_buffer_size) - wp);
-				wp = m_buffer;
-			}
-
-			wait_for_size(task_size);
-
-			new (wp) CommandType(std::forward<Args>(args)...);
-			wp = align_memory(wp + task_size, m_align);
-
-			if (wp >= m_buffer + m_buffer_size)
-			{
-				wp = m_buffer;
-			}
+		// Replaces the worker threads and their queues. Throws if any job is in flight, jobs submitted by other threads during
+		// the resize are scheduled after the new queues are created
+		ThreadManager& resize(size_t threads_count);
+		size_t threads_count() const;
 
-			m_write_pointer = wp;
-			m_push_section.unlock();
+		// Blocks until the job and all of its children are finished. Worker threads execute pending jobs while waiting
+		ThreadManager& wait(const JobHandle& handle);
+		ThreadManager& wait(std::initializer_list<JobHandle> handles);
 
-			m_has_tasks = true;
-			m_has_tasks.notify_one();
-			return *this;
+		template<typename CommandType, typename... Args>
+		inline JobHandle create_task(Args&&... args)
+		{
+			return submit(new CommandType(std::forward<Args>(args)...), nullptr, 0, {});
 		}
 
 		template<typename Function>
-		FORCE_INLINE ThreadManager& call_function(Function&& function)
+		FORCE_INLINE JobHandle call_function(Function&& function)
 		{
-			return create_task<FunctionCaller<Function>>(std::forward<Function>(function));
+			return submit(new FunctionCaller<Function>(std::forward<Function>(function)), nullptr, 0, {});
 		}
 
 		template<typename Function, typename... Args>
-		FORCE_INLINE ThreadManager& call_function(Function&& function, Args&&... args)
+		FORCE_INLINE JobHandle call_function(Function&& function, Args&&... args)
 		{
 			auto new_function = std::bind(std::forward<Function>(function), std::forward<Args>(args)...);
-			return create_task<FunctionCaller<decltype(new_function)>>(std::move(new_function));
+			return call_function(std::move(new_function));
+		}
+
+		// Job will be started only after all dependencies are finished
+		template<typename Function>
+		FORCE_INLINE JobHandle call_function_after(std::initializer_list<JobHandle> dependencies, Function&& function)
+		{
+			return submit(new FunctionCaller<Function>(std::forward<Function>(function)), dependencies.begin(),
+			              dependencies.size(), {});
+		}
+
+		// Parent job will not be finished until this job is finished. Children should be created from the body of the parent job
+		template<typename Function>
+		FORCE_INLINE JobHandle call_function_child(const JobHandle& parent, Function&& function)
+		{
+			return submit(new FunctionCaller<Function>(std::forward<Function>(function)), nullptr, 0, parent);
 		}
 	};
 }// namespace Engine
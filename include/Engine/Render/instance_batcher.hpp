@@ -0,0 +1,53 @@
+#pragma once
+#include <Core/engine_types.hpp>
+#include <Core/etl/vector.hpp>
+#include <Core/pointer.hpp>
+#include <Engine/Render/render_pass.hpp>
+#include <Graphics/gpu_buffers.hpp>
+
+namespace Engine
+{
+	// Groups mesh draws of the same surface with the same material, which differ only by the component. Each group is rendered
+	// by one instanced draw, transforms of its instances occupy a contiguous range of the per-frame instance buffer. Draws of
+	// the materials which read the transform from the model uniform are not grouped
+	class ENGINE_EXPORT InstanceBatcher final
+	{
+	public:
+		struct Batch {
+			const RenderPass::MeshDraw* draw;// State of the first draw is used by the whole batch
+			size_t first_instance;
+			size_t instances_count;
+			bool is_instanced;
+		};
+
+	private:
+		Vector<Batch> m_batches;
+		Vector<const RenderPass::MeshDraw*> m_instances;
+		// Columns of the transforms are stored in separate arrays, because RHI takes the stride of the instance stream from
+		// the attribute type
+		Pointer<TransformDynamicVertexBuffer> m_buffer;
+
+	public:
+		// Creates the instance buffer, so the batcher must be created in the logic thread
+		InstanceBatcher();
+		delete_copy_constructors(InstanceBatcher);
+
+		// Returns true if the vertex shader of the material has the transform attributes. Materials get them only if they are
+		// compiled with TRINEX_INSTANCED_TRANSFORM set to 1, which is disabled by default
+		static bool is_instanced(MaterialInterface* material);
+
+		// Groups the range of draws. Batches are placed in order of their first draws, so the draws must be already sorted
+		InstanceBatcher& add(const RenderPass::MeshDraw* const* draws, size_t count);
+
+		// Writes transforms of all instances to the instance buffer, must be called in the render thread
+		InstanceBatcher& submit();
+		InstanceBatcher& clear();
+
+		const Vector<Batch>& batches() const;
+		const Vector<const RenderPass::MeshDraw*>& instances() const;
+		TransformDynamicVertexBuffer* instance_buffer() const;
+
+		// Offset in bytes of the transform column of the instance in the instance buffer
+		size_t column_offset(size_t instance, byte column) const;
+	};
+}// namespace Engine
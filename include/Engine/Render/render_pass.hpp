@@ -1,5 +1,6 @@
 #pragma once
 #include <Core/callback.hpp>
+#include <Core/etl/frame_allocator.hpp>
 #include <Core/name.hpp>
 #include <Core/task.hpp>
 #include <Engine/Render/batched_primitives.hpp>
@@ -9,6 +10,12 @@ namespace Engine
 	class SceneRenderer;
 	class RenderViewport;
 	class SceneComponent;
+	class RenderPass;
+	class RenderCommandList;
+	class InstanceBatcher;
+	class MaterialInterface;
+	class VertexBuffer;
+	class IndexBuffer;
 
 	class ENGINE_EXPORT RenderPass
 	{
@@ -18,27 +25,60 @@ namespace Engine
 		using FunctionCallback = void(RenderViewport*, RenderPass*);
 		CallBacks<FunctionCallback> on_render;
 
+		struct VertexStream {
+			VertexBuffer* buffer;
+			size_t offset;
+			byte stream;
+		};
+
+		// Draw of the mesh surface. Consecutive draws of the pass are sorted by the key before execution, and the state which
+		// is already bound by the previous draw is not bound again. Draws of the same surface are merged into instanced draws
+		// only if the material reads the transform from the instance stream, see InstanceBatcher::is_instanced. Streams must
+		// live until the end of the frame, so they are allocated from the frame arena
+		struct ENGINE_EXPORT MeshDraw {
+			uint64_t sort_key           = 0;
+			MaterialInterface* material = nullptr;
+			SceneComponent* component   = nullptr;
+			IndexBuffer* index_buffer   = nullptr;
+			const VertexStream* streams = nullptr;
+			size_t streams_count        = 0;
+			size_t vertices_count       = 0;// Count of indices if the index buffer is used
+			size_t first_index          = 0;
+			size_t base_vertex          = 0;
+
+			// Key layout from high to low bits: pipeline, material, buffers and depth in range [0, 1], so the draws with the
+			// same state are adjacent after sorting and go from front to back
+			uint64_t build_sort_key(float depth) const;
+		};
+
 	private:
+		// Generic command, or the mesh draw if the task is nullptr. Generic commands are not reordered, so they split the
+		// sorted ranges of the draws
+		struct Command {
+			TaskInterface* task;
+			const MeshDraw* draw;
+		};
+
 		SceneRenderer* m_renderer = nullptr;
 		RenderPass* m_next        = nullptr;
 
-		Buffer m_commands;
-		size_t m_allocated = 0;
+		// Commands are allocated from the frame arena and destroyed when the pass is cleared
+		Vector<Command> m_commands;
+		InstanceBatcher* m_instances = nullptr;
 
 		template<typename Type, typename... Args>
 		Type* create_command(Args&&... args)
 		{
-			size_t start = m_allocated;
-			m_allocated += sizeof(Type);
+			Type* command = FrameArena::instance().create<Type>(std::forward<Args>(args)...);
+			commands().push_back({command, nullptr});
+			return command;
+		}
 
-			if (m_allocated > m_commands.size())
-			{
-				m_commands.resize(m_allocated);
-			}
+		Vector<Command>& commands();
 
-			byte* data = m_commands.data() + start;
-			return new (data) Type(std::forward<Args>(args)...);
-		}
+		RenderPass& release_commands();
+		RenderPass& batch_draws(const Command* begin, const Command* end);
+		RenderPass& execute_batches(size_t begin, size_t end);
 
 	protected:
 		RenderPass();
@@ -63,6 +103,7 @@ namespace Engine
 		RenderPass& bind_material(class MaterialInterface* material, SceneComponent* component = nullptr);
 		RenderPass& bind_vertex_buffer(class VertexBuffer* buffer, byte stream, size_t offset = 0);
 		RenderPass& bind_index_buffer(class IndexBuffer* buffer, size_t offset = 0);
+		RenderPass& draw_mesh(const MeshDraw& draw);
 
 		template<typename VariableType>
 		RenderPass& update_variable(VariableType& out, const VariableType& in)
@@ -88,7 +129,34 @@ namespace Engine
 		}
 
 		friend class SceneRenderer;
+		friend class RenderCommandList;
 	};
+
+	// Commands recorded by one chunk of the parallel scene traversal. While the list is bound to the thread, commands of all
+	// passes are recorded to the list instead of the passes. Lists are submitted to the passes on the render thread, so the
+	// order of the commands does not depend on the order in which worker threads finish the chunks
+	class ENGINE_EXPORT RenderCommandList final
+	{
+	private:
+		Vector<std::pair<RenderPass*, Vector<RenderPass::Command>>> m_commands;
+
+	public:
+		struct ENGINE_EXPORT Scope {
+		private:
+			RenderCommandList* m_previous;
+
+		public:
+			Scope(RenderCommandList* list);
+			delete_copy_constructors(Scope);
+			~Scope();
+		};
+
+		static RenderCommandList* current();
+
+		Vector<RenderPass::Command>& commands_of(RenderPass* pass);
+		RenderCommandList& submit();
+	};
+
 #define trinex_render_pass(name, parent)                                                                                         \
     declare_struct(name, parent);                                                                                                \
                                                                                                                                  \
@@ -35,9 +35,30 @@ namespace Engine
 	struct ENGINE_EXPORT RenderStatistics final {
 		size_t visible_objects;
 
+		// Allocations made from the frame arenas of all threads during the current frame, and the sum of peak usage of
+		// these arenas
+		size_t frame_allocations;
+		size_t peak_arena_usage;
+
+		// Binds skipped by the passes because the previous mesh draw used the same state. Pipeline is bound by the material,
+		// so skipped material binds include the pipeline binds. Material parameters depend on the component, so material
+		// binds are skipped only between surfaces of the same component
+		size_t material_binds_skipped;
+		size_t buffer_binds_skipped;
+
+		// Instanced draws created by merging of the mesh draws, and the count of the instances rendered by them
+		size_t instanced_draws;
+		size_t instances;
+
 		FORCE_INLINE RenderStatistics& reset()
 		{
-			visible_objects = 0;
+			visible_objects        = 0;
+			frame_allocations      = 0;
+			peak_arena_usage       = 0;
+			material_binds_skipped = 0;
+			buffer_binds_skipped   = 0;
+			instanced_draws        = 0;
+			instances              = 0;
 			return *this;
 		}
 	};
@@ -97,6 +118,10 @@ namespace Engine
 		virtual RenderSurface* output_surface() const;
 		virtual SceneRenderer& render(const SceneView& view, class RenderViewport* viewport);
 
+		// If true, primitives are rendered on the worker threads. Methods render_component of the primitives must only record
+		// commands to the passes in this case
+		virtual bool supports_parallel_recording() const;
+
 		// Rendering part
 
 		SceneRenderer& blit(class Texture2D* texture, const Vector2D& min = {0, 0}, const Vector2D& max = {1, 1});
@@ -158,6 +183,8 @@ namespace Engine
 			return m_overlay_pass;
 		}
 
+		bool supports_parallel_recording() const override;
+
 		// Components rendering
 		using SceneRenderer::render_component;
 		ColorSceneRenderer& render_component(StaticMeshComponent* component) override;
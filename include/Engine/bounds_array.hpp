@@ -0,0 +1,32 @@
+#pragma once
+#include <Core/engine_types.hpp>
+#include <Core/etl/vector.hpp>
+
+namespace Engine
+{
+	class AABB_3Df;
+
+	// Boxes in structure-of-arrays layout. Each component of the centers and extents is stored in its own array, so several
+	// boxes can be tested by one SIMD instruction
+	class ENGINE_EXPORT BoundsArray
+	{
+	private:
+		Vector<float> m_centers[3];
+		Vector<float> m_extents[3];
+
+	public:
+		size_t size() const;
+		bool empty() const;
+		BoundsArray& reserve(size_t size);
+		BoundsArray& clear();
+
+		BoundsArray& push(const AABB_3Df& box);
+		BoundsArray& set(size_t index, const AABB_3Df& box);
+
+		// Moves the last box to the index, so order of the boxes is not preserved
+		BoundsArray& remove_swap(size_t index);
+
+		const float* centers(size_t axis) const;
+		const float* extents(size_t axis) const;
+	};
+}// namespace Engine
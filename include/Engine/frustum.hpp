@@ -5,6 +5,7 @@ namespace Engine
 {
 	struct CameraView;
 	class AABB_3Df;
+	class BoundsArray;
 
 	struct ENGINE_EXPORT Plane {
 		Vector3D normal;
@@ -30,5 +31,9 @@ namespace Engine
 		Frustum& operator=(const CameraView& view);
 
 		bool in_frustum(const AABB_3Df& box) const;
+
+		// Tests boxes [begin, end) and writes one bit per box to the visibility mask, bit N of the mask word N / 64 is set
+		// if the box N is visible. Begin must be a multiple of 64, unused bits of the last word are cleared
+		const Frustum& in_frustum(const BoundsArray& bounds, size_t begin, size_t end, uint64_t* visibility) const;
 	};
 }// namespace Engine
@@ -1,10 +1,20 @@
 #pragma once
 #include <Core/engine_types.hpp>
-#include <Core/etl/set.hpp>
+#include <Core/etl/map.hpp>
+#include <Core/etl/vector.hpp>
 #include <Engine/aabb.hpp>
+#include <algorithm>
 
 namespace Engine
 {
+	// Loose octree. Element is stored in the deepest node whose cell contains the center of the element box and whose
+	// cell is not smaller than the box, so elements which cross the center of a node do not get stuck in the upper nodes.
+	// Cell of the node contains centers of its elements, and the elements are not larger than the cell, so the elements are
+	// within twice the cell. Bounds of the node are the union of the element boxes inserted into its subtree, they only grow
+	// until the node is released, so they are never larger than twice the cell and are much tighter for sparse nodes.
+	// Nodes are allocated from the pool in blocks, pointers to the nodes stay valid until the nodes become empty.
+	// Each element can be stored in the octree only once, the octree keeps the index of the element in the values of its
+	// node, so the elements are removed in constant time even from the crowded nodes
 	template<typename ElementType>
 	class Octree
 	{
@@ -44,179 +54,376 @@ namespace Engine
 			}
 		};
 
+		struct Update {
+			AABB_3Df old_box;
+			AABB_3Df new_box;
+			ElementType element;
+		};
+
 		class Node
 		{
 		private:
-			Node* m_childs[8];
+			Node* m_parent      = nullptr;
+			Node* m_childs[8]   = {};
 			AABB_3Df m_box;
+			Vector3D m_center   = {0.f, 0.f, 0.f};
+			float m_half_size   = 0.f;
+			byte m_index        = 0;
+			byte m_childs_count = 0;
+			bool m_has_bounds   = false;
 
-			Node()
+			FORCE_INLINE Node& setup(Node* parent, byte index, const Vector3D& center, float half_size)
 			{
-				for (int i = 0; i < 8; i++) m_childs[i] = nullptr;
+				m_parent     = parent;
+				m_index      = index;
+				m_center     = center;
+				m_half_size  = half_size;
+				m_box        = AABB_3Df(center, center);
+				m_has_bounds = false;
+				return *this;
 			}
 
-			Node(const AABB_3Df& box) : Node()
+			FORCE_INLINE Node& reset()
 			{
-				m_box = box;
+				// Capacity of the values is kept, so reused nodes do not allocate memory again
+				values.clear();
+				std::fill(std::begin(m_childs), std::end(m_childs), nullptr);
+				m_parent       = nullptr;
+				m_childs_count = 0;
+				return *this;
 			}
 
-			Node(const Node& node)
+			FORCE_INLINE bool is_unused() const
 			{
-				*this = node;
+				return m_parent && values.empty() && m_childs_count == 0;
 			}
 
-			Node& operator=(const Node& other)
+		public:
+			Vector<ElementType> values;
+
+			FORCE_INLINE Node* child_at(Octree::Index index) const
 			{
-				if (this == &other)
-					return *this;
+				return m_childs[index.index()];
+			}
 
-				m_box  = other.m_box;
-				values = other.values;
+			// Bounds of the elements of the node and of its children
+			FORCE_INLINE const AABB_3Df& box() const
+			{
+				return m_box;
+			}
 
-				for (int i = 0; i < 8; i++)
-				{
-					if (other.m_childs[i])
-					{
-						if (!m_childs[i])
-						{
-							m_childs[i] = new Octree::Node(*other.m_childs[i]);
-						}
-						else
-						{
-							(*m_childs[i]) = *other.m_childs[i];
-						}
-					}
-					else if (m_childs[i])
-					{
-						delete m_childs[i];
-						m_childs[i] = nullptr;
-					}
-				}
+			FORCE_INLINE const Vector3D& center() const
+			{
+				return m_center;
 			}
 
-			~Node()
+			FORCE_INLINE float half_size() const
 			{
-				for (int i = 0; i < 8; i++)
-				{
-					if (m_childs[i] != nullptr)
-					{
-						delete m_childs[i];
-						m_childs[i] = nullptr;
-					}
-				}
+				return m_half_size;
 			}
 
+			friend class Octree;
+		};
+
+	private:
+		static constexpr size_t block_size = 64;
+
+		Vector<Node*> m_blocks;
+		Vector<Node*> m_free_nodes;
+		Map<ElementType, size_t> m_slots;
+		Node* m_root_node = nullptr;
+		float m_min_size  = 1.0f;
 
-			FORCE_INLINE Node*& ref_child_at(Octree::Index index)
+		static FORCE_INLINE float radius_of(const AABB_3Df& box)
+		{
+			const Vector3D extents = (box.max() - box.min()) * 0.5f;
+			return glm::max(extents.x, glm::max(extents.y, extents.z));
+		}
+
+		static FORCE_INLINE Octree::Index child_index(const Node* node, const Vector3D& point)
+		{
+			return Octree::Index(point.x >= node->m_center.x, point.y >= node->m_center.y, point.z >= node->m_center.z);
+		}
+
+		// Cells are half-open, so the cells of the children split the cell of the parent in the same way as child_index
+		static FORCE_INLINE bool cell_contains(const Node* node, const Vector3D& point)
+		{
+			const Vector3D min = node->m_center - Vector3D(node->m_half_size);
+			const Vector3D max = node->m_center + Vector3D(node->m_half_size);
+			return glm::all(glm::greaterThanEqual(point, min)) && glm::all(glm::lessThan(point, max));
+		}
+
+		FORCE_INLINE bool can_descend(const Node* node, float radius) const
+		{
+			const float child_half_size = node->m_half_size * 0.5f;
+			return child_half_size >= radius && node->m_half_size >= m_min_size;
+		}
+
+		// Returns true if find() of the box returns this node
+		FORCE_INLINE bool is_target_of(const Node* node, const Vector3D& center, float radius) const
+		{
+			if (node->m_half_size < radius || can_descend(node, radius))
+				return false;
+
+			// Path is checked by the same comparisons as find() uses, so rounding of the cell bounds does not matter
+			for (; node->m_parent; node = node->m_parent)
 			{
-				return m_childs[index.index()];
+				if (child_index(node->m_parent, center).index() != node->m_index)
+					return false;
 			}
 
-		public:
-			TreeSet<ElementType> values;
+			return cell_contains(node, center);
+		}
 
-			FORCE_INLINE Node* child_at(Octree::Index index) const
+		// Grows bounds of the node and of its parents, so they contain the box
+		static FORCE_INLINE void expand(Node* node, const AABB_3Df& box)
+		{
+			for (; node; node = node->m_parent)
 			{
-				return m_childs[index.index()];
+				if (!node->m_has_bounds)
+				{
+					node->m_box        = box;
+					node->m_has_bounds = true;
+					continue;
+				}
+
+				const Vector3D& min = node->m_box.min();
+				const Vector3D& max = node->m_box.max();
+
+				if (glm::all(glm::lessThanEqual(min, box.min())) && glm::all(glm::greaterThanEqual(max, box.max())))
+					return;
+
+				node->m_box.minmax(glm::min(min, box.min()), glm::max(max, box.max()));
 			}
+		}
 
-			FORCE_INLINE const AABB_3Df& box() const
+		Node* allocate_node()
+		{
+			if (m_free_nodes.empty())
 			{
-				return m_box;
+				Node* block = new Node[block_size];
+				m_blocks.push_back(block);
+
+				for (size_t index = block_size; index > 0; --index)
+				{
+					m_free_nodes.push_back(block + index - 1);
+				}
 			}
 
-			friend class Octree;
-		};
+			Node* node = m_free_nodes.back();
+			m_free_nodes.pop_back();
+			return node;
+		}
 
-	private:
-		Node* m_root_node = nullptr;
-		float m_min_size  = 1.0f;
+		Node* create_child(Node* node, Octree::Index index)
+		{
+			const float half_size = node->m_half_size * 0.5f;
+			Node* child           = allocate_node();
+			child->setup(node, index.index(), node->m_center + index.factor() * half_size, half_size);
 
-		static FORCE_INLINE bool calc_axis_offset_index(float parent, float child)
+			node->m_childs[index.index()] = child;
+			++node->m_childs_count;
+			return child;
+		}
+
+		// Releases empty nodes from the node up to the root
+		Node* prune(Node* node)
 		{
-			return parent < child;
+			while (node->is_unused())
+			{
+				Node* parent                    = node->m_parent;
+				parent->m_childs[node->m_index] = nullptr;
+				--parent->m_childs_count;
+
+				node->reset();
+				m_free_nodes.push_back(node);
+				node = parent;
+			}
+
+			return node;
 		}
 
-		static FORCE_INLINE Octree::Index calc_child_index(const AABB_3Df& parent, const AABB_3Df& child)
+		FORCE_INLINE bool contains_value(const Node* node, const ElementType& element) const
 		{
-			Octree::Index result;
-			auto parent_center = parent.center();
-			auto child_center  = child.center();
-			result.x           = calc_axis_offset_index(parent_center.x, child_center.x);
-			result.y           = calc_axis_offset_index(parent_center.y, child_center.y);
-			result.z           = calc_axis_offset_index(parent_center.z, child_center.z);
-			return result;
+			auto it = m_slots.find(element);
+			return it != m_slots.end() && it->second < node->values.size() && node->values[it->second] == element;
+		}
+
+		FORCE_INLINE bool erase_value(Node* node, const ElementType& element)
+		{
+			auto it = m_slots.find(element);
+
+			if (it == m_slots.end())
+				return false;
+
+			const size_t slot = it->second;
+
+			if (slot >= node->values.size() || !(node->values[slot] == element))
+				return false;
+
+			// Order of the elements does not matter, so the last element is moved to the place of the removed one
+			m_slots.erase(it);
+
+			if (slot + 1 < node->values.size())
+			{
+				node->values[slot]          = std::move(node->values.back());
+				m_slots[node->values[slot]] = slot;
+			}
+
+			node->values.pop_back();
+			return true;
 		}
 
-		static FORCE_INLINE bool is_child_of(const AABB_3Df& parent, const AABB_3Df& child)
+		FORCE_INLINE void insert_value(Node* node, const ElementType& element)
 		{
-			return child.inside(parent) && !child.contains(parent.center());
+			m_slots[element] = node->values.size();
+			node->values.push_back(element);
+		}
+
+		Node* move_internal(const AABB_3Df& old_box, const AABB_3Df& new_box, const ElementType& element, Node*& old_node)
+		{
+			old_node = find(old_box);
+
+			if (old_node && is_target_of(old_node, new_box.center(), radius_of(new_box)))
+			{
+				Node* node = old_node;
+
+				if (!contains_value(node, element))
+					insert_value(node, element);
+
+				expand(node, new_box);
+				old_node = nullptr;
+				return node;
+			}
+
+			if (old_node && !erase_value(old_node, element))
+				old_node = nullptr;
+
+			return push(new_box, element);
 		}
 
 	public:
 		Octree(float min_size = 1.0f) : m_min_size(min_size)
 		{
-			m_root_node = new Octree::Node(AABB_3Df({0.0f, 0.0f, 0.0f}, {min_size, min_size, min_size}));
+			m_root_node = allocate_node();
+			m_root_node->setup(nullptr, 0, Vector3D(min_size * 0.5f), min_size * 0.5f);
 		}
 
+		Octree(const Octree&)            = delete;
+		Octree& operator=(const Octree&) = delete;
+
 		FORCE_INLINE Node* root_node() const
 		{
 			return m_root_node;
 		}
 
+		// Element must not be in the octree already, use move to change its box
 		FORCE_INLINE Node* push(const AABB_3Df& box, const ElementType& element)
 		{
 			Node* node = find_or_create(box);
-			node->values.insert(element);
+			insert_value(node, element);
+			expand(node, box);
 			return node;
 		}
 
+		// Returns the node which contained the element, or its first ancestor if the node was released
 		FORCE_INLINE Node* remove(const AABB_3Df& box, const ElementType& element)
 		{
 			Node* node = find(box);
-			if (node)
+
+			if (node && erase_value(node, element))
 			{
-				node->values.erase(element);
+				node = prune(node);
 			}
 
 			return node;
 		}
 
+		// Moves the element to the new box. Element stays in the same node if the node is still the target node of the box
+		Node* move(const AABB_3Df& old_box, const AABB_3Df& new_box, const ElementType& element)
+		{
+			Node* old_node = nullptr;
+			Node* node     = move_internal(old_box, new_box, element, old_node);
+
+			if (old_node)
+				prune(old_node);
+
+			return node;
+		}
+
+		// Moves several elements at once. Empty nodes are released only after all elements are moved, so nodes which are
+		// emptied and filled again by the same batch are not reallocated
+		Octree& update(const Update* updates, size_t count)
+		{
+			Vector<Node*> old_nodes;
+			old_nodes.reserve(count);
+
+			for (size_t index = 0; index < count; ++index)
+			{
+				const Update& update = updates[index];
+				Node* old_node       = nullptr;
+				move_internal(update.old_box, update.new_box, update.element, old_node);
+
+				if (old_node)
+					old_nodes.push_back(old_node);
+			}
+
+			// Released nodes have no parent, so the duplicates are skipped
+			for (Node* node : old_nodes)
+			{
+				prune(node);
+			}
+
+			return *this;
+		}
+
 		FORCE_INLINE Node* find(const AABB_3Df& box) const
 		{
-			Node* node = m_root_node;
+			const Vector3D center = box.center();
+			const float radius    = radius_of(box);
+			Node* node            = m_root_node;
 
-			if (!box.inside(node->m_box))
+			if (!cell_contains(node, center) || node->m_half_size < radius)
 				return nullptr;
 
-			while (node && is_child_of(node->m_box, box))
+			while (node && can_descend(node, radius))
 			{
-				node = node->child_at(calc_child_index(node->m_box, box));
+				node = node->child_at(child_index(node, center));
 			}
 			return node;
 		}
 
 		FORCE_INLINE Node* find_or_create(const AABB_3Df& box)
 		{
-			Node* node = m_root_node;
+			const Vector3D center = box.center();
+			const float radius    = radius_of(box);
 
-			while (!box.inside(node->m_box))
+			while (!cell_contains(m_root_node, center) || m_root_node->m_half_size < radius)
 			{
-				Octree::Index index = calc_child_index(box, node->m_box);
-				node                = new Octree::Node((node->m_box * 2.0f) + (node->m_box.size() / 2.0f) * (!index).factor());
-				node->m_childs[index.index()] = m_root_node;
-				m_root_node                   = node;
+				// Root grows towards the box, the old root becomes the child of the new root
+				Node* old_root        = m_root_node;
+				Octree::Index index   = child_index(old_root, center);
+				const float half_size = old_root->m_half_size * 2.f;
+
+				m_root_node = allocate_node();
+				m_root_node->setup(nullptr, 0, old_root->m_center + index.factor() * old_root->m_half_size, half_size);
+
+				const byte old_index             = (!index).index();
+				m_root_node->m_childs[old_index] = old_root;
+				m_root_node->m_childs_count      = 1;
+				m_root_node->m_box               = old_root->m_box;
+				m_root_node->m_has_bounds        = old_root->m_has_bounds;
+				old_root->m_parent               = m_root_node;
+				old_root->m_index                = old_index;
 			}
 
-			while (node && node->m_box.size().x / 2 >= m_min_size && is_child_of(node->m_box, box))
+			Node* node = m_root_node;
+
+			while (can_descend(node, radius))
 			{
-				Octree::Index index = calc_child_index(node->m_box, box);
-				if (node->m_childs[index.index()] == nullptr)
-				{
-					node->m_childs[index.index()] =
-					        new Octree::Node((node->m_box * 0.5) + (node->m_box.size() * 0.25f) * index.factor());
-				}
-				node = node->m_childs[index.index()];
+				Octree::Index index = child_index(node, center);
+				Node* child         = node->child_at(index);
+				node                = child ? child : create_child(node, index);
 			}
 
 			return node;
@@ -224,7 +431,10 @@ namespace Engine
 
 		~Octree()
 		{
-			delete m_root_node;
+			for (Node* block : m_blocks)
+			{
+				delete[] block;
+			}
 		}
 	};
 }// namespace Engine
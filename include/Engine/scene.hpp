@@ -1,8 +1,10 @@
 #pragma once
 #include <Core/engine_types.hpp>
+#include <Core/etl/map.hpp>
 #include <Core/name.hpp>
 #include <Core/pointer.hpp>
 #include <Core/structures.hpp>
+#include <Engine/bounds_array.hpp>
 #include <Engine/enviroment.hpp>
 #include <Engine/octree.hpp>
 
@@ -28,6 +30,14 @@ namespace Engine
 		LightOctree m_light_octree;
 		Pointer<SceneComponent> m_root_component;
 
+		// Flat list of the render thread primitives, bounds of the primitive N are stored at index N of the bounds array
+		Vector<PrimitiveComponent*> m_primitives_render_thread;
+		Map<PrimitiveComponent*, size_t> m_primitive_indices_render_thread;
+		BoundsArray m_primitive_bounds_render_thread;
+
+		Scene& push_primitive_render_thread(PrimitiveComponent* primitive, const AABB_3Df& box);
+		Scene& remove_primitive_render_thread(PrimitiveComponent* primitive);
+
 	public:
 		WorldEnvironment environment;
 
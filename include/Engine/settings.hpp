@@ -8,13 +8,16 @@ namespace Engine::Settings
 	extern ENGINE_EXPORT String default_language;
 	extern ENGINE_EXPORT String current_language;
 	extern ENGINE_EXPORT int_t lz4_compression_level;
-	extern ENGINE_EXPORT int_t gc_max_object_per_tick;
+	extern ENGINE_EXPORT int_t gc_tick_budget;         // Microseconds per frame
+	extern ENGINE_EXPORT int_t async_load_tick_budget; // Microseconds per frame
 	extern ENGINE_EXPORT int_t fps_limit;
+	extern ENGINE_EXPORT int_t frames_in_flight;
 	extern ENGINE_EXPORT float screen_percentage;
 	extern ENGINE_EXPORT Vector<String> languages;
 	extern ENGINE_EXPORT Vector<String> systems;
 	extern ENGINE_EXPORT Vector<String> plugins;
 	extern ENGINE_EXPORT bool debug_shaders;
+	extern ENGINE_EXPORT bool packed_assets; // Mount <assets_dir>.pak instead of the assets directory, if it exists
 
 	namespace GPU
 	{
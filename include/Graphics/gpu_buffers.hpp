@@ -280,6 +280,11 @@ namespace Engine
 		declare_class(BitangentDynamicVertexBuffer, VertexBuffer);
 	};
 
+	class ENGINE_EXPORT TransformDynamicVertexBuffer : public TypedDynamicVertexBuffer<Vector4D>
+	{
+		declare_class(TransformDynamicVertexBuffer, VertexBuffer);
+	};
+
 	///////////////// INDEX BUFFER /////////////////
 
 	class ENGINE_EXPORT IndexBuffer : public GPUBuffer
@@ -1,11 +1,157 @@
 #include <Core/archive.hpp>
+#include <Core/asset_loader.hpp>
 #include <Core/buffer_manager.hpp>
+#include <Core/logger.hpp>
 #include <Core/object.hpp>
 #include <Core/reflection/class.hpp>
 #include <Core/reflection/struct.hpp>
+#include <algorithm>
+#include <bit>
 
 namespace Engine
 {
+	ArchiveTables::ArchiveTables(bool is_transient) : m_is_transient(is_transient)
+	{}
+
+	uint32_t ArchiveTables::name_index(const Name& name)
+	{
+		if (!name.is_valid())
+			return none_index;
+
+		auto [it, inserted] = m_name_indices.try_emplace(name, static_cast<uint32_t>(m_names.size()));
+
+		if (inserted)
+			m_names.push_back(name);
+
+		return it->second;
+	}
+
+	uint32_t ArchiveTables::import_index(const String& name)
+	{
+		if (name.empty())
+			return none_index;
+
+		auto [it, inserted] = m_import_indices.try_emplace(name, static_cast<uint32_t>(m_imports.size()));
+
+		if (inserted)
+			m_imports.push_back(name);
+
+		return it->second;
+	}
+
+	uint32_t ArchiveTables::import_index(Object* object)
+	{
+		if (object == nullptr)
+			return none_index;
+
+		auto [it, inserted] = m_object_indices.try_emplace(object, static_cast<uint32_t>(m_resolved_imports.size()));
+
+		if (inserted)
+		{
+			m_resolved_imports.push_back(object);
+			m_is_import_resolved.push_back(true);
+		}
+
+		return it->second;
+	}
+
+	const Name& ArchiveTables::name(uint32_t index) const
+	{
+		if (index >= m_names.size())
+			return Name::none;
+		return m_names[index];
+	}
+
+	Object* ArchiveTables::import_object(uint32_t index)
+	{
+		if (index >= m_resolved_imports.size())
+			return nullptr;
+
+		// Each import is resolved only once, the next references reuse the result
+		if (!m_is_import_resolved[index])
+		{
+			m_resolved_imports[index]   = Archive::load_object(m_imports[index]);
+			m_is_import_resolved[index] = true;
+		}
+
+		return m_resolved_imports[index];
+	}
+
+	ArchiveTables& ArchiveTables::import_object(uint32_t index, Object* object)
+	{
+		if (index < m_resolved_imports.size())
+		{
+			m_resolved_imports[index]   = object;
+			m_is_import_resolved[index] = true;
+		}
+		return *this;
+	}
+
+	bool ArchiveTables::is_transient() const
+	{
+		return m_is_transient;
+	}
+
+	const Vector<Name>& ArchiveTables::names() const
+	{
+		return m_names;
+	}
+
+	const Vector<String>& ArchiveTables::imports() const
+	{
+		return m_imports;
+	}
+
+	const Vector<Object*>& ArchiveTables::resolved_imports() const
+	{
+		return m_resolved_imports;
+	}
+
+	bool ArchiveTables::serialize(Archive& ar)
+	{
+		if (m_is_transient)
+			return false;
+
+		if (ar.is_saving())
+		{
+			uint32_t count = static_cast<uint32_t>(m_names.size());
+			ar.serialize(count);
+
+			for (Name& name : m_names)
+			{
+				String value = name.to_string();
+				ar.serialize(value);
+			}
+
+			return ar.serialize_container(m_imports);
+		}
+
+		if (!ar.is_reading())
+			return false;
+
+		uint32_t count = 0;
+		ar.serialize(count);
+
+		m_names.clear();
+		m_names.reserve(count);
+		m_name_indices.clear();
+
+		String value;
+
+		for (uint32_t i = 0; i < count && ar; ++i)
+		{
+			ar.serialize(value);
+			m_names.emplace_back(value);
+		}
+
+		ar.serialize_container(m_imports);
+
+		m_resolved_imports.assign(m_imports.size(), nullptr);
+		m_is_import_resolved.assign(m_imports.size(), false);
+		m_import_indices.clear();
+		return ar;
+	}
+
 	Archive::Archive() : m_reader(nullptr), m_is_saving(false), m_process_status(false)
 	{}
 
@@ -42,22 +188,59 @@ namespace Engine
 			return *this;
 
 		m_reader         = other.m_reader;
+		m_tables         = other.m_tables;
 		m_process_status = other.m_process_status;
 		m_is_saving      = other.m_is_saving;
 
 		other.m_process_status = false;
 		other.m_reader         = nullptr;
+		other.m_tables         = nullptr;
 		other.m_is_saving      = false;
 
 		return *this;
 	}
 
-	class Object* Archive::load_object(const StringView& name, class Refl::Class* self)
+	Object* Archive::load_object(const StringView& name)
 	{
-		Object* object = Object::load_object(name);
-		if (object && object->class_instance()->is_a(self))
-			return object;
-		return nullptr;
+		return AssetLoader::is_resolving_references() ? AssetLoader::resolve_reference(name) : Object::load_object(name);
+	}
+
+	bool Archive::serialize_object_reference(Object*& object, Refl::Class* self)
+	{
+		if (m_tables)
+		{
+			uint32_t index = ArchiveTables::none_index;
+
+			if (is_saving() && object)
+			{
+				index = m_tables->is_transient() ? m_tables->import_index(object) : m_tables->import_index(object->full_name());
+			}
+
+			serialize(index);
+
+			if (is_reading())
+			{
+				object = m_tables->import_object(index);
+			}
+		}
+		else if (is_saving())
+		{
+			String name = object ? object->full_name() : "";
+			serialize(name);
+		}
+		else if (is_reading())
+		{
+			String name;
+			serialize(name);
+			object = name.empty() ? nullptr : load_object(name);
+		}
+
+		if (is_reading() && object && !object->class_instance()->is_a(self))
+		{
+			object = nullptr;
+		}
+
+		return *this;
 	}
 
 	bool Archive::serialize_struct(Refl::Struct* self, void* obj)
@@ -85,6 +268,17 @@ namespace Engine
 		return m_is_saving ? m_writer : nullptr;
 	}
 
+	ArchiveTables* Archive::tables() const
+	{
+		return m_tables;
+	}
+
+	Archive& Archive::tables(ArchiveTables* tables)
+	{
+		m_tables = tables;
+		return *this;
+	}
+
 	Archive& Archive::write_data(const byte* data, size_t size)
 	{
 		if (is_saving())
@@ -105,6 +299,27 @@ namespace Engine
 		return *this;
 	}
 
+	bool Archive::read_buffer_view(Span<const byte>& span, Buffer& storage)
+	{
+		if (!is_reading())
+			return false;
+
+		size_t size = 0;
+		serialize(size);
+
+		if (!m_process_status)
+			return false;
+
+		if (!m_reader->read_span(span, size))
+		{
+			storage.resize(size);
+			m_process_status = m_reader->read(storage.data(), size);
+			span             = storage;
+		}
+
+		return m_process_status;
+	}
+
 	size_t Archive::position() const
 	{
 		if (is_saving())
@@ -146,6 +361,78 @@ namespace Engine
 		return false;
 	}
 
+	// Count of the bulk serialized vectors has the highest bit set if the data was written by big endian platform
+	static constexpr size_t big_endian_bit = static_cast<size_t>(1) << (sizeof(size_t) * 8 - 1);
+	static constexpr bool is_big_endian    = std::endian::native == std::endian::big;
+
+	bool Archive::serialize_bulk_count(size_t& count, size_t element_size, bool& is_swapped)
+	{
+		if (is_saving())
+		{
+			size_t value = is_big_endian ? (count | big_endian_bit) : count;
+			serialize(value);
+			is_swapped = false;
+			return m_process_status;
+		}
+
+		if (!is_reading())
+			return false;
+
+		size_t value = 0;
+		serialize(value);
+
+		count      = value & ~big_endian_bit;
+		is_swapped = static_cast<bool>(value & big_endian_bit) != is_big_endian;
+
+		// Corrupted count must not allocate more memory than the reader can provide
+		const size_t position = m_reader->position();
+		const size_t size     = m_reader->size();
+
+		if (position > size || (element_size > 0 && count > (size - position) / element_size))
+		{
+			error_log("Archive", "Size of the serialized vector exceeds size of the data");
+			m_process_status = false;
+			count            = 0;
+		}
+
+		return m_process_status;
+	}
+
+	bool Archive::serialize_bulk_data(byte* data, size_t size, size_t swap_unit, bool is_swapped)
+	{
+		if (size == 0)
+			return m_process_status;
+
+		if (is_saving())
+		{
+			m_process_status = m_writer->write(data, size) && m_process_status;
+			return m_process_status;
+		}
+
+		if (!is_reading())
+			return false;
+
+		m_process_status = m_reader->read(data, size) && m_process_status;
+
+		if (is_swapped && m_process_status)
+		{
+			if (swap_unit == 0)
+			{
+				error_log("Archive", "Cannot convert byte order of the serialized vector");
+				m_process_status = false;
+			}
+			else if (swap_unit > 1)
+			{
+				for (byte* scalar = data; scalar < data + size; scalar += swap_unit)
+				{
+					std::reverse(scalar, scalar + swap_unit);
+				}
+			}
+		}
+
+		return m_process_status;
+	}
+
 	bool Archive::serialize_string(String& str)
 	{
 		size_t size = str.length();
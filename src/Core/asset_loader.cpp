@@ -0,0 +1,546 @@
+#include <Core/asset_loader.hpp>
+#include <Core/constants.hpp>
+#include <Core/etl/atomic.hpp>
+#include <Core/etl/critical_section.hpp>
+#include <Core/etl/map.hpp>
+#include <Core/exception.hpp>
+#include <Core/file_manager.hpp>
+#include <Core/filesystem/path.hpp>
+#include <Core/garbage_collector.hpp>
+#include <Core/object.hpp>
+#include <Core/thread_manager.hpp>
+#include <Core/threading.hpp>
+#include <Engine/settings.hpp>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+namespace Engine
+{
+	// States after Finished are final
+	enum class LoadState : EnumerateType
+	{
+		Queued    = 0,
+		Reading   = 1,
+		Ready     = 2,
+		Finished  = 3,
+		Failed    = 4,
+		Cancelled = 5,
+	};
+
+	struct LoadHandle::Request {
+		String name;
+		LoadPriority priority = LoadPriority::Normal;
+		size_t sequence       = 0;
+		LoadState state       = LoadState::Queued;
+
+		// Written by the worker thread, read by the logic thread after the request is returned to the completed list
+		Atomic<bool> is_cancelled = false;
+		bool is_read              = false;
+		Buffer data;
+		Vector<String> imports;
+
+		Object* object = nullptr;
+		Vector<CallBack<void(Object*)>> callbacks;
+		Vector<SharedPtr<Request>> dependencies;
+
+		FORCE_INLINE bool is_finished() const
+		{
+			return state >= LoadState::Finished;
+		}
+	};
+
+	using LoadRequest = LoadHandle::Request;
+
+	// State of one attempt to create the object. Objects which are loaded inline during the attempt are committed only if
+	// the attempt has no missing dependencies
+	struct LoadContext {
+		SharedPtr<LoadRequest> root;
+		Vector<SharedPtr<LoadRequest>> stack;
+		Vector<SharedPtr<LoadRequest>> missing;
+		Vector<Pair<SharedPtr<LoadRequest>, Object*>> loaded;
+		Vector<SharedPtr<LoadRequest>> failed;
+	};
+
+	static struct AssetLoaderState {
+		Map<String, SharedPtr<LoadRequest>> requests;
+		Vector<SharedPtr<LoadRequest>> queue;
+		Vector<SharedPtr<LoadRequest>> ready;
+		size_t reading_count  = 0;
+		size_t next_sequence  = 0;
+		size_t total_count    = 0;
+		size_t finished_count = 0;
+		LoadContext* context  = nullptr;
+
+		CriticalSection section;
+		Vector<SharedPtr<LoadRequest>> completed;
+	} loader_state;
+
+	static FORCE_INLINE bool has_higher_priority(const SharedPtr<LoadRequest>& a, const SharedPtr<LoadRequest>& b)
+	{
+		if (a->priority != b->priority)
+			return a->priority > b->priority;
+		return a->sequence < b->sequence;
+	}
+
+	template<typename Container, typename Value>
+	static FORCE_INLINE bool contains(const Container& container, const Value& value)
+	{
+		return std::find(container.begin(), container.end(), value) != container.end();
+	}
+
+	static SharedPtr<LoadRequest> create_request(StringView fullname, LoadPriority priority)
+	{
+		auto request      = std::make_shared<LoadRequest>();
+		request->name     = String(fullname);
+		request->priority = priority;
+		request->sequence = loader_state.next_sequence++;
+
+		loader_state.requests[request->name] = request;
+		loader_state.queue.push_back(request);
+		++loader_state.total_count;
+		return request;
+	}
+
+	static void release_request(const SharedPtr<LoadRequest>& request, LoadState state)
+	{
+		request->state   = state;
+		request->data    = {};
+		request->imports = {};
+
+		auto it = loader_state.requests.find(request->name);
+		if (it != loader_state.requests.end() && it->second == request)
+		{
+			loader_state.requests.erase(it);
+		}
+
+		++loader_state.finished_count;
+	}
+
+	static void complete_request(SharedPtr<LoadRequest> request, Object* object)
+	{
+		request->object = object;
+		release_request(request, object ? LoadState::Finished : LoadState::Failed);
+
+		// Callbacks can create new requests, so they are moved out of the request first
+		auto callbacks = std::move(request->callbacks);
+
+		for (auto& callback : callbacks)
+		{
+			callback(object);
+		}
+	}
+
+	static bool dependencies_finished(const SharedPtr<LoadRequest>& request)
+	{
+		for (auto& dependency : request->dependencies)
+		{
+			if (!dependency->is_finished())
+				return false;
+		}
+		return true;
+	}
+
+	void AssetLoader::dispatch_requests()
+	{
+		ThreadManager* manager = ThreadManager::instance();
+		const size_t max_reads = glm::max<size_t>(1, manager->threads_count());
+		auto& queue            = loader_state.queue;
+
+		while (loader_state.reading_count < max_reads && !queue.empty())
+		{
+			auto it                        = std::min_element(queue.begin(), queue.end(), has_higher_priority);
+			SharedPtr<LoadRequest> request = std::move(*it);
+			queue.erase(it);
+
+			if (request->state != LoadState::Queued)
+				continue;
+
+			request->state = LoadState::Reading;
+			++loader_state.reading_count;
+
+			manager->call_function([request]() {
+				if (!request->is_cancelled.load(std::memory_order_relaxed))
+				{
+					FileReader reader(Object::asset_path_of(request->name));
+					request->is_read = reader.is_open() && Object::read_asset_data(&reader, request->data, &request->imports);
+				}
+
+				ScopeLock lock(loader_state.section);
+				loader_state.completed.push_back(request);
+			});
+		}
+	}
+
+	Object* AssetLoader::load_request(const SharedPtr<LoadRequest>& request)
+	{
+		LoadContext& context = *loader_state.context;
+		const size_t missing = context.missing.size();
+
+		context.stack.push_back(request);
+		Object* object = Object::load_object_from_data(request->name, request->data);
+		context.stack.pop_back();
+
+		if (request != context.root)
+		{
+			if (object)
+				context.loaded.push_back({request, object});
+			else if (context.missing.size() == missing)
+				context.failed.push_back(request);
+		}
+
+		return object;
+	}
+
+	static bool is_visited_import(const Vector<LoadRequest*>& visited, const String& name)
+	{
+		for (LoadRequest* request : visited)
+		{
+			const String& loading = request->name;
+
+			// Asset itself and its subobjects are created during the deserialization
+			if (name.starts_with(loading) && (name.size() == loading.size() ||
+			                                  StringView(name).substr(loading.size()).starts_with(Constants::name_separator)))
+				return true;
+		}
+		return false;
+	}
+
+	// Finds the imports of the request and of its imports which are not read yet, and requests them
+	static void request_imports(LoadContext& context, LoadRequest* request, Vector<LoadRequest*>& visited)
+	{
+		visited.push_back(request);
+
+		for (const String& name : request->imports)
+		{
+			if (name.empty() || is_visited_import(visited, name) || Object::static_find_object(name))
+				continue;
+
+			// Finished requests are removed from the requests map, imports which failed to load are resolved to nullptr
+			if (std::any_of(context.root->dependencies.begin(), context.root->dependencies.end(),
+			                [&name](const SharedPtr<LoadRequest>& dependency) {
+				                return dependency->name == name && dependency->is_finished();
+			                }))
+				continue;
+
+			auto it = loader_state.requests.find(name);
+
+			if (it == loader_state.requests.end())
+			{
+				context.missing.push_back(create_request(name, context.root->priority));
+			}
+			else if (it->second->state == LoadState::Ready)
+			{
+				request_imports(context, it->second.get(), visited);
+			}
+			else if (!it->second->is_finished() && !contains(context.missing, it->second))
+			{
+				context.missing.push_back(it->second);
+			}
+		}
+	}
+
+	void AssetLoader::finalize_request(const SharedPtr<LoadRequest>& request)
+	{
+		LoadContext context;
+		context.root = request;
+
+		// Object is created only when all assets which it references directly or through other assets are read, so it is
+		// deserialized once. Assets saved without the list of references are checked during the deserialization
+		Vector<LoadRequest*> visited;
+		request_imports(context, request.get(), visited);
+
+		Object* object = nullptr;
+
+		if (context.missing.empty())
+		{
+			loader_state.context = &context;
+			object               = load_request(request);
+			loader_state.context = nullptr;
+		}
+
+		if (!context.missing.empty())
+		{
+			// Objects loaded in this attempt can reference the objects which were deleted because of missing dependencies
+			for (auto it = context.loaded.rbegin(); it != context.loaded.rend(); ++it)
+			{
+				GarbageCollector::destroy(it->second);
+			}
+
+			for (auto& dependency : context.missing)
+			{
+				request->dependencies.push_back(dependency);
+			}
+			return;
+		}
+
+		for (auto& [dependency, dependency_object] : context.loaded)
+		{
+			complete_request(dependency, dependency_object);
+		}
+
+		for (auto& dependency : context.failed)
+		{
+			complete_request(dependency, nullptr);
+		}
+
+		complete_request(request, object);
+	}
+
+	bool AssetLoader::is_resolving_references()
+	{
+		return loader_state.context != nullptr;
+	}
+
+	Object* AssetLoader::resolve_reference(StringView fullname)
+	{
+		if (Object* object = Object::static_find_object(fullname))
+			return object;
+
+		LoadContext& context = *loader_state.context;
+		String name(fullname);
+
+		// References which cannot be loaded are resolved to nullptr, like in the synchronous loading
+		for (auto& dependency : context.root->dependencies)
+		{
+			if (dependency->name == name && dependency->state == LoadState::Failed)
+				return nullptr;
+		}
+
+		for (auto& dependency : context.failed)
+		{
+			if (dependency->name == name)
+				return nullptr;
+		}
+
+		SharedPtr<LoadRequest> request;
+		auto it = loader_state.requests.find(name);
+
+		if (it != loader_state.requests.end())
+		{
+			request = it->second;
+
+			if (request->state == LoadState::Ready)
+			{
+				if (contains(context.stack, request))
+					return nullptr;
+
+				return load_request(request);
+			}
+		}
+		else
+		{
+			request = create_request(fullname, context.root->priority);
+		}
+
+		if (!contains(context.missing, request))
+		{
+			context.missing.push_back(request);
+		}
+
+		return nullptr;
+	}
+
+	size_t AssetLoader::missing_dependencies_count()
+	{
+		return loader_state.context ? loader_state.context->missing.size() : 0;
+	}
+
+	LoadHandle AssetLoader::load(StringView fullname, LoadPriority priority)
+	{
+		trinex_always_check(is_in_logic_thread(), "Asynchronous loading must be started from the logic thread!");
+
+		if (Object* object = Object::static_find_object(fullname))
+		{
+			auto request    = std::make_shared<LoadRequest>();
+			request->name   = String(fullname);
+			request->state  = LoadState::Finished;
+			request->object = object;
+			return LoadHandle(request);
+		}
+
+		auto it = loader_state.requests.find(String(fullname));
+
+		if (it != loader_state.requests.end())
+		{
+			it->second->priority = std::max(it->second->priority, priority);
+			return LoadHandle(it->second);
+		}
+
+		return LoadHandle(create_request(fullname, priority));
+	}
+
+	void AssetLoader::update()
+	{
+		Vector<SharedPtr<LoadRequest>> completed;
+		{
+			ScopeLock lock(loader_state.section);
+			completed.swap(loader_state.completed);
+		}
+
+		for (auto& request : completed)
+		{
+			--loader_state.reading_count;
+
+			if (request->state == LoadState::Cancelled)
+				continue;
+
+			if (request->is_read)
+			{
+				request->state = LoadState::Ready;
+				loader_state.ready.push_back(request);
+			}
+			else
+			{
+				complete_request(request, nullptr);
+			}
+		}
+
+		dispatch_requests();
+
+		auto& ready = loader_state.ready;
+		std::sort(ready.begin(), ready.end(), has_higher_priority);
+
+		using Clock   = std::chrono::steady_clock;
+		auto deadline = Clock::now() + std::chrono::microseconds(glm::max<int_t>(1, Settings::async_load_tick_budget));
+
+		// Callbacks can call LoadHandle::wait, which reenters this function and modifies the ready list, so the requests are
+		// finalized from a copy. Requests added by the callbacks are processed in the next update
+		const Vector<SharedPtr<LoadRequest>> finalizing = ready;
+
+		for (const SharedPtr<LoadRequest>& request : finalizing)
+		{
+			if (request->state != LoadState::Ready || !dependencies_finished(request))
+				continue;
+
+			finalize_request(request);
+
+			if (Clock::now() >= deadline)
+				break;
+		}
+
+		ready.erase(std::remove_if(ready.begin(), ready.end(),
+		                           [](const SharedPtr<LoadRequest>& request) { return request->state != LoadState::Ready; }),
+		            ready.end());
+
+		// Dependencies which were found during the finalization
+		dispatch_requests();
+
+		if (loader_state.requests.empty())
+		{
+			loader_state.total_count    = 0;
+			loader_state.finished_count = 0;
+		}
+	}
+
+	size_t AssetLoader::pending_count()
+	{
+		return loader_state.requests.size();
+	}
+
+	float AssetLoader::progress()
+	{
+		if (loader_state.total_count == 0)
+			return 1.f;
+		return static_cast<float>(loader_state.finished_count) / static_cast<float>(loader_state.total_count);
+	}
+
+	LoadHandle::LoadHandle() = default;
+
+	LoadHandle::LoadHandle(const SharedPtr<Request>& request) : m_request(request)
+	{}
+
+	bool LoadHandle::is_valid() const
+	{
+		return m_request != nullptr;
+	}
+
+	bool LoadHandle::is_finished() const
+	{
+		return m_request && m_request->is_finished();
+	}
+
+	bool LoadHandle::is_cancelled() const
+	{
+		return m_request && m_request->state == LoadState::Cancelled;
+	}
+
+	float LoadHandle::progress() const
+	{
+		if (!m_request)
+			return 0.f;
+
+		switch (m_request->state)
+		{
+			case LoadState::Queued:
+				return 0.f;
+
+			case LoadState::Reading:
+				return 0.25f;
+
+			case LoadState::Ready:
+			{
+				size_t finished = 0;
+
+				for (auto& dependency : m_request->dependencies)
+				{
+					finished += dependency->is_finished() ? 1 : 0;
+				}
+
+				return 0.5f + 0.5f * static_cast<float>(finished) / static_cast<float>(m_request->dependencies.size() + 1);
+			}
+
+			default:
+				return 1.f;
+		}
+	}
+
+	Object* LoadHandle::object() const
+	{
+		return m_request ? m_request->object : nullptr;
+	}
+
+	const LoadHandle& LoadHandle::on_finished(const CallBack<void(Object*)>& callback) const
+	{
+		if (!m_request)
+			return *this;
+
+		if (m_request->is_finished())
+		{
+			if (m_request->state != LoadState::Cancelled)
+				callback(m_request->object);
+		}
+		else
+		{
+			m_request->callbacks.push_back(callback);
+		}
+
+		return *this;
+	}
+
+	const LoadHandle& LoadHandle::cancel() const
+	{
+		if (!m_request || m_request->is_finished())
+			return *this;
+
+		m_request->is_cancelled.store(true, std::memory_order_relaxed);
+		m_request->callbacks.clear();
+
+		// Request can still be in the queue, in the ready list or in the worker thread, it will be skipped there
+		release_request(m_request, LoadState::Cancelled);
+		return *this;
+	}
+
+	Object* LoadHandle::wait() const
+	{
+		trinex_always_check(is_in_logic_thread(), "LoadHandle::wait must be called from the logic thread!");
+
+		while (m_request && !m_request->is_finished())
+		{
+			AssetLoader::update();
+			std::this_thread::yield();
+		}
+
+		return object();
+	}
+}// namespace Engine
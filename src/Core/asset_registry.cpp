@@ -0,0 +1,412 @@
+#include <Core/archive.hpp>
+#include <Core/asset_registry.hpp>
+#include <Core/constants.hpp>
+#include <Core/etl/critical_section.hpp>
+#include <Core/etl/map.hpp>
+#include <Core/etl/set.hpp>
+#include <Core/file_flag.hpp>
+#include <Core/file_manager.hpp>
+#include <Core/filesystem/directory_iterator.hpp>
+#include <Core/filesystem/root_filesystem.hpp>
+#include <Core/logger.hpp>
+#include <Core/object.hpp>
+#include <Core/parallel.hpp>
+#include <Core/string_functions.hpp>
+#include <Engine/project.hpp>
+
+namespace Engine
+{
+	// Assets saved before the dependencies list was introduced have the size of the compressed data after the file flag
+	static constexpr size_t dependencies_marker = 0x5350454441534E54;// TNSADEPS
+
+	struct RegistryState {
+		CriticalSection section;
+		TreeMap<String, Vector<String>, std::less<>> dependencies;
+		TreeMap<String, TreeSet<String, std::less<>>, std::less<>> referencers;
+
+		// Content hashes of the asset files, saving skips the assets whose files already store the same content
+		TreeMap<String, HashIndex, std::less<>> content_hashes;
+	};
+
+	static RegistryState& registry_state()
+	{
+		static RegistryState* state = new RegistryState();
+		return *state;
+	}
+
+	static void unlink_asset(RegistryState& state, StringView fullname)
+	{
+		auto it = state.dependencies.find(fullname);
+
+		if (it == state.dependencies.end())
+			return;
+
+		for (const String& dependency : it->second)
+		{
+			auto referencers = state.referencers.find(dependency);
+
+			if (referencers == state.referencers.end())
+				continue;
+
+			referencers->second.erase(it->first);
+
+			if (referencers->second.empty())
+				state.referencers.erase(referencers);
+		}
+
+		state.dependencies.erase(it);
+	}
+
+	static void link_asset(RegistryState& state, StringView fullname, const Vector<String>& dependencies)
+	{
+		unlink_asset(state, fullname);
+
+		auto& entry = state.dependencies[String(fullname)];
+		entry.reserve(dependencies.size());
+
+		for (const String& dependency : dependencies)
+		{
+			if (dependency == fullname || std::find(entry.begin(), entry.end(), dependency) != entry.end())
+				continue;
+
+			entry.push_back(dependency);
+			state.referencers[dependency].emplace(fullname);
+		}
+	}
+
+	static bool read_asset_header(const Path& path, AssetRegistry::Header& header)
+	{
+		FileReader reader(path);
+
+		if (!reader.is_open())
+			return false;
+
+		Archive ar(&reader);
+		return AssetRegistry::read_header(ar, &header);
+	}
+
+	static void register_asset(RegistryState& state, StringView fullname, const AssetRegistry::Header& header)
+	{
+		link_asset(state, fullname, header.dependencies);
+
+		auto it = state.content_hashes.find(fullname);
+
+		if (it == state.content_hashes.end())
+			state.content_hashes.emplace(String(fullname), header.content_hash);
+		else
+			it->second = header.content_hash;
+	}
+
+	static String asset_name_of(const Path& path)
+	{
+		Path relative = path.relative(Project::assets_dir);
+		String name   = Strings::replace_all(relative.base_path(), Path::sv_separator, Constants::name_separator);
+
+		if (!name.empty())
+			name += Constants::name_separator;
+
+		name += relative.stem();
+		return name;
+	}
+
+	bool AssetRegistry::write_header(Archive& ar, const Header& header)
+	{
+		FileFlag flag     = FileFlag::asset_flag();
+		size_t marker     = dependencies_marker;
+		size_t size       = sizeof(size_t) + sizeof(HashIndex);
+		HashIndex content = header.content_hash;
+
+		for (const String& dependency : header.dependencies)
+		{
+			size += sizeof(size_t) + dependency.size();
+		}
+
+		// Size of the header allows to skip it and to add new fields later
+		ar.serialize(flag, marker, size);
+		ar.serialize_container(const_cast<Vector<String>&>(header.dependencies));
+		ar.serialize(content);
+		return ar;
+	}
+
+	bool AssetRegistry::read_header(Archive& ar, Header* header)
+	{
+		FileFlag flag = FileFlag::asset_flag();
+		ar.serialize(flag);
+
+		if (!ar || flag != FileFlag::asset_flag())
+			return false;
+
+		if (header)
+			(*header) = Header();
+
+		size_t marker = 0;
+		ar.serialize(marker);
+
+		if (marker != dependencies_marker)
+		{
+			ar.position(ar.position() - sizeof(size_t));
+			return ar;
+		}
+
+		size_t size = 0;
+		ar.serialize(size);
+
+		const size_t end = ar.position() + size;
+
+		if (header)
+		{
+			ar.serialize_container(header->dependencies);
+
+			if (ar.position() + sizeof(HashIndex) <= end)
+				ar.serialize(header->content_hash);
+		}
+
+		ar.position(end);
+		return ar;
+	}
+
+	size_t AssetRegistry::scan()
+	{
+		Vector<Path> paths;
+
+		for (const Path& path : VFS::RecursiveDirectoryIterator(Project::assets_dir))
+		{
+			if (path.extension() == Constants::asset_extention && rootfs()->is_file(path))
+			{
+				paths.push_back(path);
+			}
+		}
+
+		Vector<Header> headers(paths.size());
+		Vector<byte> is_valid(paths.size(), 0);
+
+		parallel_for(paths.size(), 1, [&](size_t index) {
+			is_valid[index] = read_asset_header(paths[index], headers[index]);
+		});
+
+		RegistryState& state = registry_state();
+		ScopeLock lock(state.section);
+
+		state.dependencies.clear();
+		state.referencers.clear();
+		state.content_hashes.clear();
+
+		size_t count = 0;
+
+		for (size_t index = 0; index < paths.size(); ++index)
+		{
+			if (is_valid[index])
+			{
+				register_asset(state, asset_name_of(paths[index]), headers[index]);
+				++count;
+			}
+			else
+			{
+				warn_log("AssetRegistry", "Failed to read header of the asset '%s'", paths[index].c_str());
+			}
+		}
+
+		return count;
+	}
+
+	bool AssetRegistry::refresh(StringView fullname)
+	{
+		Header header;
+
+		if (!read_asset_header(Object::asset_path_of(fullname), header))
+		{
+			remove(fullname);
+			return false;
+		}
+
+		update(fullname, header);
+		return true;
+	}
+
+	void AssetRegistry::update(StringView fullname, const Header& header)
+	{
+		RegistryState& state = registry_state();
+		ScopeLock lock(state.section);
+		register_asset(state, fullname, header);
+	}
+
+	void AssetRegistry::remove(StringView fullname)
+	{
+		RegistryState& state = registry_state();
+		ScopeLock lock(state.section);
+		unlink_asset(state, fullname);
+
+		auto it = state.content_hashes.find(fullname);
+
+		if (it != state.content_hashes.end())
+			state.content_hashes.erase(it);
+	}
+
+	bool AssetRegistry::is_saved(StringView fullname, HashIndex content_hash)
+	{
+		RegistryState& state = registry_state();
+		ScopeLock lock(state.section);
+
+		// Assets saved without the header have no hash
+		auto it = state.content_hashes.find(fullname);
+		return it != state.content_hashes.end() && it->second != 0 && it->second == content_hash;
+	}
+
+	bool AssetRegistry::contains(StringView fullname)
+	{
+		RegistryState& state = registry_state();
+		ScopeLock lock(state.section);
+		return state.dependencies.contains(fullname);
+	}
+
+	Vector<String> AssetRegistry::assets()
+	{
+		RegistryState& state = registry_state();
+		ScopeLock lock(state.section);
+
+		Vector<String> result;
+		result.reserve(state.dependencies.size());
+
+		for (auto& [name, dependencies] : state.dependencies)
+		{
+			result.push_back(name);
+		}
+
+		return result;
+	}
+
+	Vector<String> AssetRegistry::dependencies(StringView fullname)
+	{
+		RegistryState& state = registry_state();
+		ScopeLock lock(state.section);
+
+		auto it = state.dependencies.find(fullname);
+		return it != state.dependencies.end() ? it->second : Vector<String>();
+	}
+
+	Vector<String> AssetRegistry::referencers(StringView fullname)
+	{
+		RegistryState& state = registry_state();
+		ScopeLock lock(state.section);
+
+		auto it = state.referencers.find(fullname);
+
+		if (it == state.referencers.end())
+			return {};
+
+		return Vector<String>(it->second.begin(), it->second.end());
+	}
+
+	Vector<String> AssetRegistry::dependency_closure(const Vector<String>& roots)
+	{
+		RegistryState& state = registry_state();
+		ScopeLock lock(state.section);
+
+		static const Vector<String> empty;
+
+		struct Frame {
+			const String* name;
+			const Vector<String>* dependencies;
+			size_t next;
+		};
+
+		TreeSet<StringView> visited;
+		Vector<String> result;
+		Vector<Frame> stack;
+
+		auto push = [&](const String& name) {
+			if (!visited.insert(name).second)
+				return;
+
+			auto it = state.dependencies.find(name);
+			stack.push_back({&name, it != state.dependencies.end() ? &it->second : &empty, 0});
+		};
+
+		// Iterative post-order traversal, so deep graphs do not overflow the stack
+		for (const String& root : roots)
+		{
+			push(root);
+
+			while (!stack.empty())
+			{
+				Frame& frame = stack.back();
+
+				if (frame.next < frame.dependencies->size())
+				{
+					push((*frame.dependencies)[frame.next++]);
+				}
+				else
+				{
+					result.push_back(*frame.name);
+					stack.pop_back();
+				}
+			}
+		}
+
+		return result;
+	}
+
+	Vector<String> AssetRegistry::referencer_closure(StringView fullname)
+	{
+		RegistryState& state = registry_state();
+		ScopeLock lock(state.section);
+
+		TreeSet<StringView> visited = {fullname};
+		Vector<StringView> queue    = {fullname};
+		Vector<String> result;
+
+		for (size_t index = 0; index < queue.size(); ++index)
+		{
+			auto it = state.referencers.find(queue[index]);
+
+			if (it == state.referencers.end())
+				continue;
+
+			for (const String& referencer : it->second)
+			{
+				if (visited.insert(referencer).second)
+				{
+					queue.push_back(referencer);
+					result.push_back(referencer);
+				}
+			}
+		}
+
+		return result;
+	}
+
+	Vector<String> AssetRegistry::unused_assets(const Vector<String>& roots)
+	{
+		Vector<String> used = dependency_closure(roots);
+		TreeSet<StringView> used_set(used.begin(), used.end());
+
+		RegistryState& state = registry_state();
+		ScopeLock lock(state.section);
+
+		Vector<String> result;
+
+		for (auto& [name, dependencies] : state.dependencies)
+		{
+			if (!used_set.contains(name))
+			{
+				result.push_back(name);
+			}
+		}
+
+		return result;
+	}
+
+	Vector<LoadHandle> AssetRegistry::prefetch(const Vector<String>& roots, LoadPriority priority)
+	{
+		Vector<String> closure = dependency_closure(roots);
+		Vector<LoadHandle> handles;
+		handles.reserve(closure.size());
+
+		for (const String& name : closure)
+		{
+			handles.push_back(AssetLoader::load(name, priority));
+		}
+
+		return handles;
+	}
+}// namespace Engine
@@ -1,5 +1,7 @@
+#include <Core/asset_loader.hpp>
 #include <Core/base_engine.hpp>
 #include <Core/config_manager.hpp>
+#include <Core/etl/frame_allocator.hpp>
 #include <Core/garbage_collector.hpp>
 #include <Core/profiler.hpp>
 #include <Core/reflection/class.hpp>
@@ -14,16 +16,34 @@
 
 namespace Engine
 {
+	struct BeginRenderFrameCommand : public Task<BeginRenderFrameCommand> {
+		float* m_start_time;
+
+		BeginRenderFrameCommand(float* start_time) : m_start_time(start_time)
+		{}
+
+		void execute() override
+		{
+			(*m_start_time) = engine_instance->time_seconds();
+		}
+	};
+
 	struct SubmitCommand : public Task<SubmitCommand> {
-		CriticalSection* m_signal;
+		float* m_start_time;
+		Atomic<float>* m_render_time;
+		Atomic<Index>* m_rendered_frames;
 
-		SubmitCommand(CriticalSection* signal) : m_signal(signal)
+		SubmitCommand(float* start_time, Atomic<float>* render_time, Atomic<Index>* rendered_frames)
+		    : m_start_time(start_time), m_render_time(render_time), m_rendered_frames(rendered_frames)
 		{}
 
 		void execute() override
 		{
 			rhi->submit();
-			m_signal->unlock();
+			FrameArena::end_frame();
+			(*m_render_time) = engine_instance->time_seconds() - (*m_start_time);
+			++(*m_rendered_frames);
+			m_rendered_frames->notify_all();
 		}
 	};
 
@@ -38,9 +58,12 @@ namespace Engine
 
 	BaseEngine::BaseEngine()
 	{
-		start_time    = current_time_point();
-		m_frame_index = 0;
-		m_prev_time   = 0.f;
+		start_time          = current_time_point();
+		m_frame_index       = 0;
+		m_prev_time         = 0.f;
+		m_rendered_frames   = 0;
+		m_render_time       = 0.f;
+		m_render_start_time = 0.f;
 
 		flags(StandAlone, true);
 		flags(IsAvailableForGC, false);
@@ -52,6 +75,42 @@ namespace Engine
 		return 0;
 	}
 
+	BaseEngine& BaseEngine::wait_for_render_thread()
+	{
+		const Index max_frames = frames_in_flight();
+
+		while (true)
+		{
+			const Index rendered = m_rendered_frames.load();
+
+			if (m_submitted_frames - rendered < max_frames)
+				break;
+
+			m_rendered_frames.wait(rendered);
+		}
+		return *this;
+	}
+
+	BaseEngine& BaseEngine::update_frame_statistics(float logic_time, float wait_time)
+	{
+		m_average_frame_time.push(m_delta_time);
+		m_average_logic_time.push(logic_time);
+		m_average_wait_time.push(wait_time);
+		m_average_render_time.push(m_render_time.load());
+
+		auto& stats       = m_frame_statistics;
+		stats.frame_time  = m_average_frame_time.average();
+		stats.logic_time  = m_average_logic_time.average();
+		stats.render_time = m_average_render_time.average();
+		stats.wait_time   = m_average_wait_time.average();
+
+		const float serial_time   = stats.logic_time + stats.render_time;
+		const float min_time      = glm::min(stats.logic_time, stats.render_time);
+		const float parallel_time = serial_time - stats.frame_time;
+		stats.overlap             = min_time > 0.f ? glm::clamp(parallel_time / min_time, 0.f, 1.f) : 0.f;
+		return *this;
+	}
+
 	int_t BaseEngine::update()
 	{
 		trinex_profile_frame_mark();
@@ -65,6 +124,7 @@ namespace Engine
 		++m_frame_index;
 
 		GarbageCollector::update(m_delta_time);
+		AssetLoader::update();
 
 		if (auto instance = EngineSystem::instance())
 		{
@@ -84,7 +144,11 @@ namespace Engine
 				max_vp_size = glm::max(max_vp_size, viewport->size());
 			}
 
-			m_render_end_signal.lock();
+			const float logic_end_time = time_seconds();
+			wait_for_render_thread();
+			const float wait_time = time_seconds() - logic_end_time;
+
+			render_thread()->create_task<BeginRenderFrameCommand>(&m_render_start_time);
 			SceneRenderTargets::instance()->initialize(max_vp_size);
 
 			for (size_t i = 0; i < viewports.size(); ++i)
@@ -93,7 +157,10 @@ namespace Engine
 				viewport->render();
 			}
 
-			render_thread()->create_task<SubmitCommand>(&m_render_end_signal);
+			render_thread()->create_task<SubmitCommand>(&m_render_start_time, &m_render_time, &m_rendered_frames);
+			++m_submitted_frames;
+
+			update_frame_statistics(logic_end_time - current_time, wait_time);
 		}
 		return 0;
 	}
@@ -161,5 +228,15 @@ namespace Engine
 		return m_frame_index;
 	}
 
+	Index BaseEngine::frames_in_flight() const
+	{
+		return static_cast<Index>(glm::clamp(Settings::frames_in_flight, 1, 3));
+	}
+
+	const BaseEngine::FrameStatistics& BaseEngine::frame_statistics() const
+	{
+		return m_frame_statistics;
+	}
+
 	ENGINE_EXPORT BaseEngine* engine_instance = nullptr;
 }// namespace Engine
@@ -38,6 +38,30 @@ namespace Engine
 		return offset(pos, BufferSeekDir::Begin);
 	}
 
+	bool BufferReader::read_span(Span<const byte>& span, size_t size)
+	{
+		if (size == 0)
+		{
+			span = {};
+			return true;
+		}
+
+		Span<const byte> data = view();
+		ReadPos pos           = position();
+
+		if (data.data() == nullptr || pos > data.size() || data.size() - pos < size)
+			return false;
+
+		span = data.subspan(pos, size);
+		offset(static_cast<PosOffset>(size));
+		return true;
+	}
+
+	Span<const byte> BufferReader::view()
+	{
+		return {};
+	}
+
 
 	void VectorWriterBase::copy_data(byte* to, const byte* from, size_t count)
 	{
@@ -1,41 +1,342 @@
 #include <Core/compressor.hpp>
 #include <Core/exception.hpp>
+#include <Core/memory.hpp>
+#include <Core/parallel.hpp>
 #include <Engine/settings.hpp>
+#include <cstring>
 #include <lz4hc.h>
 
 namespace Engine::Compressor
 {
+	static FORCE_INLINE bool is_chunked(const byte* src, size_t size)
+	{
+		uint32_t value[2];
+
+		if (size < sizeof(Header))
+			return false;
+
+		std::memcpy(value, src, sizeof(value));
+		return value[0] == magic && value[1] == version;
+	}
 
-	ENGINE_EXPORT void compress(const Buffer& src, Buffer& dst)
+	static bool read_block_table(const byte* src, size_t size, Header& header, Vector<Block>& blocks, Vector<uint64_t>& offsets)
 	{
-		int input_size = static_cast<int>(src.size());
-		int out_size   = LZ4_compressBound(input_size);
+		std::memcpy(&header, src, sizeof(Header));
 
-		dst.clear();
-		dst.resize(out_size + sizeof(size_t));
+		if (header.block_size == 0 || header.blocks_count != (header.original_size + header.block_size - 1) / header.block_size)
+			return false;
+
+		if ((size - sizeof(Header)) / sizeof(Block) < header.blocks_count)
+			return false;
+
+		blocks.resize(header.blocks_count);
+		offsets.resize(header.blocks_count);
+		std::memcpy(blocks.data(), src + sizeof(Header), blocks.size() * sizeof(Block));
+
+		uint64_t offset   = sizeof(Header) + blocks.size() * sizeof(Block);
+		uint64_t original = 0;
 
-		out_size =
-		        LZ4_compress_HC(reinterpret_cast<const char*>(src.data()), reinterpret_cast<char*>(dst.data() + sizeof(size_t)),
-								input_size, out_size, Settings::lz4_compression_level);
+		for (size_t index = 0; index < blocks.size(); ++index)
+		{
+			const Block& block = blocks[index];
+			offsets[index]     = offset;
+			offset += block.compressed_size;
+			original += block.original_size;
+
+			if (block.original_size > header.block_size || block.compressed_size > block.original_size)
+				return false;
+
+			// Blocks are decoded to index * block_size, so only the last block can be shorter
+			if (index + 1 < blocks.size() && block.original_size != header.block_size)
+				return false;
+		}
 
-		dst.resize(out_size + sizeof(size_t));
-		(*reinterpret_cast<size_t*>(dst.data())) = src.size();
+		return offset <= size && original == header.original_size;
 	}
 
-	ENGINE_EXPORT void decompress(const Buffer& src, Buffer& dst)
+	static bool decode_block(const byte* src, const Block& block, byte* dst)
 	{
-		int input_size = static_cast<int>(src.size() - sizeof(size_t));
-		dst.resize(*reinterpret_cast<const size_t*>(src.data()));
+		if (memory_hash_fast(src, block.compressed_size, 0) != block.checksum)
+			return false;
+
+		if (block.compressed_size == block.original_size)
+		{
+			std::memcpy(dst, src, block.original_size);
+			return true;
+		}
+
+		const int size = LZ4_decompress_safe(reinterpret_cast<const char*>(src), reinterpret_cast<char*>(dst),
+		                                     static_cast<int>(block.compressed_size), static_cast<int>(block.original_size));
+		return size >= 0 && static_cast<uint32_t>(size) == block.original_size;
+	}
+
+	// Data written before chunked format was introduced is a single block with the original size prefix
+	static bool decompress_legacy(const byte* src, size_t size, Buffer& dst)
+	{
+		if (size < sizeof(size_t))
+			return false;
+
+		size_t original_size;
+		std::memcpy(&original_size, src, sizeof(size_t));
+
+		int input_size = static_cast<int>(size - sizeof(size_t));
+		dst.resize(original_size);
 		int out_size = static_cast<int>(dst.size());
 
-		out_size = LZ4_decompress_safe(reinterpret_cast<const char*>(src.data() + sizeof(size_t)),
-		                               reinterpret_cast<char*>(dst.data()), input_size, out_size);
+		out_size = LZ4_decompress_safe(reinterpret_cast<const char*>(src + sizeof(size_t)), reinterpret_cast<char*>(dst.data()),
+		                               input_size, out_size);
 
 		if (out_size < 0)
+			return false;
+
+		dst.resize(out_size);
+		return true;
+	}
+
+	StreamReader::StreamReader(Span<const byte> compressed) : m_data(compressed)
+	{
+		if (is_chunked(m_data.data(), m_data.size()))
 		{
-			throw EngineException("LZ4: Failed to decompress data!");
+			m_is_open = read_block_table(m_data.data(), m_data.size(), m_header, m_blocks, m_offsets);
+		}
+		else if (decompress_legacy(m_data.data(), m_data.size(), m_block))
+		{
+			// Legacy data is decompressed at once and read as the single block
+			m_header.block_size    = static_cast<uint32_t>(glm::max<size_t>(m_block.size(), 1));
+			m_header.original_size = m_block.size();
+			m_header.blocks_count  = 1;
+			m_block_index          = 0;
+			m_is_open              = true;
+		}
+	}
+
+	StreamReader::~StreamReader()
+	{
+		if (m_next_job)
+			ThreadManager::instance()->wait(m_next_job);
+	}
+
+	void StreamReader::prefetch_block(size_t index)
+	{
+		if (index >= m_blocks.size())
+			return;
+
+		m_next_block_index = index;
+		m_next_block.resize(m_blocks[index].original_size);
+
+		m_next_job = ThreadManager::instance()->call_function([this, index]() {
+			m_next_block_status = decode_block(m_data.data() + m_offsets[index], m_blocks[index], m_next_block.data());
+		});
+	}
+
+	bool StreamReader::load_block(size_t index)
+	{
+		if (index == m_block_index)
+			return true;
+
+		if (index >= m_blocks.size())
+			return false;
+
+		if (m_next_job)
+		{
+			ThreadManager::instance()->wait(m_next_job);
+			m_next_job.reset();
 		}
 
-		dst.resize(out_size);
+		bool status;
+
+		if (index == m_next_block_index)
+		{
+			std::swap(m_block, m_next_block);
+			status = m_next_block_status;
+		}
+		else
+		{
+			m_block.resize(m_blocks[index].original_size);
+			status = decode_block(m_data.data() + m_offsets[index], m_blocks[index], m_block.data());
+		}
+
+		m_next_block_index = ~static_cast<size_t>(0);
+
+		if (!status)
+		{
+			m_block_index = ~static_cast<size_t>(0);
+			return false;
+		}
+
+		m_block_index = index;
+		prefetch_block(index + 1);
+		return true;
+	}
+
+	bool StreamReader::read(byte* data, size_t size)
+	{
+		if (!m_is_open || m_position + size > m_header.original_size)
+			return false;
+
+		while (size > 0)
+		{
+			const size_t index  = m_position / m_header.block_size;
+			const size_t offset = m_position % m_header.block_size;
+
+			if (!load_block(index))
+			{
+				m_is_open = false;
+				return false;
+			}
+
+			const size_t count = glm::min<size_t>(size, m_block.size() - offset);
+			std::memcpy(data, m_block.data() + offset, count);
+
+			data += count;
+			size -= count;
+			m_position += count;
+		}
+
+		return true;
+	}
+
+	StreamReader::ReadPos StreamReader::position()
+	{
+		return m_position;
+	}
+
+	StreamReader& StreamReader::offset(PosOffset offset, BufferSeekDir dir)
+	{
+		if (dir == BufferSeekDir::Begin)
+			m_position = 0;
+		else if (dir == BufferSeekDir::End)
+			m_position = m_header.original_size;
+
+		m_position += offset;
+		return *this;
+	}
+
+	bool StreamReader::is_open() const
+	{
+		return m_is_open;
+	}
+
+	ENGINE_EXPORT Codec default_codec()
+	{
+#if TRINEX_DEBUG_BUILD
+		return Codec::LZ4;
+#else
+		return Codec::LZ4HC;
+#endif
+	}
+
+	ENGINE_EXPORT void compress(const Buffer& src, Buffer& dst, Codec codec)
+	{
+		compress(src.data(), src.size(), dst, codec);
+	}
+
+	ENGINE_EXPORT void compress(const byte* src, size_t size, Buffer& dst, Codec codec)
+	{
+		Header header;
+		header.magic         = magic;
+		header.version       = version;
+		header.codec         = codec;
+		header.block_size    = block_size;
+		header.original_size = size;
+		header.blocks_count  = (size + block_size - 1) / block_size;
+
+		Vector<Block> blocks(header.blocks_count);
+		Vector<Buffer> data(header.blocks_count);
+
+		parallel_for(blocks.size(), 1, [&](size_t index) {
+			const byte* block_data = src + index * block_size;
+			const int input_size   = static_cast<int>(glm::min<size_t>(block_size, size - index * block_size));
+			Buffer& output         = data[index];
+
+			output.resize(LZ4_compressBound(input_size));
+
+			const char* input = reinterpret_cast<const char*>(block_data);
+			char* out         = reinterpret_cast<char*>(output.data());
+			int out_size;
+
+			if (codec == Codec::LZ4HC)
+				out_size = LZ4_compress_HC(input, out, input_size, static_cast<int>(output.size()), Settings::lz4_compression_level);
+			else
+				out_size = LZ4_compress_default(input, out, input_size, static_cast<int>(output.size()));
+
+			// Store block as is if compression does not reduce its size
+			if (out_size <= 0 || out_size >= input_size)
+			{
+				output.assign(block_data, block_data + input_size);
+				out_size = input_size;
+			}
+
+			output.resize(out_size);
+
+			Block& block          = blocks[index];
+			block.compressed_size = static_cast<uint32_t>(out_size);
+			block.original_size   = static_cast<uint32_t>(input_size);
+			block.checksum        = memory_hash_fast(output.data(), output.size(), 0);
+		});
+
+		size_t total_size = sizeof(Header) + blocks.size() * sizeof(Block);
+
+		for (const Buffer& block : data)
+		{
+			total_size += block.size();
+		}
+
+		dst.clear();
+		dst.resize(total_size);
+
+		byte* out = dst.data();
+		std::memcpy(out, &header, sizeof(Header));
+		out += sizeof(Header);
+
+		std::memcpy(out, blocks.data(), blocks.size() * sizeof(Block));
+		out += blocks.size() * sizeof(Block);
+
+		for (const Buffer& block : data)
+		{
+			std::memcpy(out, block.data(), block.size());
+			out += block.size();
+		}
+	}
+
+	ENGINE_EXPORT void decompress(const Buffer& src, Buffer& dst)
+	{
+		decompress(src.data(), src.size(), dst);
+	}
+
+	ENGINE_EXPORT void decompress(const byte* src, size_t size, Buffer& dst)
+	{
+		if (!is_chunked(src, size))
+		{
+			if (!decompress_legacy(src, size, dst))
+			{
+				throw EngineException("LZ4: Failed to decompress data!");
+			}
+			return;
+		}
+
+		Header header;
+		Vector<Block> blocks;
+		Vector<uint64_t> offsets;
+
+		if (!read_block_table(src, size, header, blocks, offsets))
+		{
+			throw EngineException("LZ4: Compressed data is corrupted!");
+		}
+
+		dst.resize(header.original_size);
+		Atomic<bool> status = true;
+
+		parallel_for(blocks.size(), 1, [&](size_t index) {
+			if (!decode_block(src + offsets[index], blocks[index], dst.data() + index * header.block_size))
+			{
+				status = false;
+			}
+		});
+
+		if (!status)
+		{
+			throw EngineException("LZ4: Failed to decompress data!");
+		}
 	}
 }// namespace Engine::Compressor
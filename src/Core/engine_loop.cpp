@@ -1,4 +1,5 @@
 #include <Core/arguments.hpp>
+#include <Core/asset_registry.hpp>
 #include <Core/base_engine.hpp>
 #include <Core/config_manager.hpp>
 #include <Core/constants.hpp>
@@ -10,6 +11,7 @@
 #include <Core/garbage_collector.hpp>
 #include <Core/library.hpp>
 #include <Core/logger.hpp>
+#include <Core/package.hpp>
 #include <Core/reflection/class.hpp>
 #include <Core/reflection/struct.hpp>
 #include <Core/thread.hpp>
@@ -153,6 +155,10 @@ namespace Engine
 			return execute_entry(entry_param->get<const String&>());
 		}
 
+		// Dependency graph is used to prefetch assets concurrently, so it is built before any asset is loaded
+		const size_t assets_count = AssetRegistry::scan();
+		info_log("EngineLoop", "Registered %zu assets", assets_count);
+
 		init_api();
 		create_main_window();
 
@@ -224,6 +230,8 @@ namespace Engine
 			render_thread()->wait();
 		}
 
+		// Files of the background saves must be written before the worker threads are stopped
+		Package::wait_for_async_saves();
 		GarbageCollector::destroy_all_objects();
 		render_thread()->wait();
 
@@ -18,7 +18,8 @@ namespace Engine
 
 	implement_engine_enum(VertexBufferSemantic, VertexBufferSemantic::Position, VertexBufferSemantic::TexCoord,
 						  VertexBufferSemantic::Color, VertexBufferSemantic::Normal, VertexBufferSemantic::Tangent,
-						  VertexBufferSemantic::Bitangent, VertexBufferSemantic::BlendWeight, VertexBufferSemantic::BlendIndices);
+						  VertexBufferSemantic::Bitangent, VertexBufferSemantic::BlendWeight, VertexBufferSemantic::BlendIndices,
+						  VertexBufferSemantic::Transform);
 
 	implement_engine_enum(Coord, Coord::X, Coord::Y, Coord::Z);
 
@@ -0,0 +1,218 @@
+#include <Core/etl/atomic.hpp>
+#include <Core/etl/critical_section.hpp>
+#include <Core/etl/frame_allocator.hpp>
+#include <algorithm>
+#include <cstdint>
+
+namespace Engine
+{
+	static Atomic<FrameArena::size_type> m_current_frame = 0;
+	static constexpr FrameArena::size_type header_size   = 2 * FrameArena::default_alignment;
+
+	static CriticalSection& arenas_section()
+	{
+		static CriticalSection section;
+		return section;
+	}
+
+	static Vector<FrameArena*>& arenas()
+	{
+		static Vector<FrameArena*> arenas;
+		return arenas;
+	}
+
+	static FORCE_INLINE unsigned char* align_pointer(unsigned char* ptr, FrameArena::size_type align)
+	{
+		auto address = reinterpret_cast<std::uintptr_t>(ptr);
+		return reinterpret_cast<unsigned char*>((address + align - 1) & ~static_cast<std::uintptr_t>(align - 1));
+	}
+
+	static FORCE_INLINE unsigned char* page_data(void* page)
+	{
+		return reinterpret_cast<unsigned char*>(page) + header_size;
+	}
+
+	FrameArena::FrameArena() : m_frame(m_current_frame.load())
+	{
+		ScopeLock lock(arenas_section());
+		arenas().push_back(this);
+	}
+
+	FrameArena::~FrameArena()
+	{
+		{
+			ScopeLock lock(arenas_section());
+			auto& list = arenas();
+			list.erase(std::remove(list.begin(), list.end(), this), list.end());
+		}
+
+		ByteAllocator allocator;
+
+		while (m_first_page)
+		{
+			Page* next = m_first_page->next;
+			allocator.deallocate(reinterpret_cast<unsigned char*>(m_first_page), m_first_page->size);
+			m_first_page = next;
+		}
+	}
+
+	FrameArena& FrameArena::instance()
+	{
+		static thread_local FrameArena arena;
+
+		const size_type frame = m_current_frame.load(std::memory_order_relaxed);
+
+		if (arena.m_frame.load(std::memory_order_relaxed) != frame)
+		{
+			arena.reset();
+			arena.m_frame.store(frame, std::memory_order_relaxed);
+		}
+
+		return arena;
+	}
+
+	void FrameArena::end_frame()
+	{
+		m_current_frame.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	FrameArena::Statistics FrameArena::statistics()
+	{
+		const size_type frame = m_current_frame.load(std::memory_order_relaxed);
+		Statistics statistics;
+
+		ScopeLock lock(arenas_section());
+
+		for (FrameArena* arena : arenas())
+		{
+			// Arena is reset on the first access in the frame, so the arenas which were not used keep old allocations
+			if (arena->m_frame.load(std::memory_order_relaxed) == frame)
+				statistics.allocations += arena->m_allocations.load(std::memory_order_relaxed);
+
+			statistics.peak_usage += arena->m_peak_usage.load(std::memory_order_relaxed);
+		}
+
+		return statistics;
+	}
+
+	void FrameArena::next_page(size_type size, size_type align)
+	{
+		if (m_current_page)
+		{
+			m_used_in_pages += m_current_page->size - (m_end - m_cursor);
+
+			// Try to reuse pages which were allocated in the previous frames
+			if (Page* next = m_current_page->next)
+			{
+				unsigned char* data = align_pointer(page_data(next), align);
+
+				if (data + size <= reinterpret_cast<unsigned char*>(next) + next->size)
+				{
+					m_current_page = next;
+					m_cursor       = page_data(next);
+					m_end          = reinterpret_cast<unsigned char*>(next) + next->size;
+					return;
+				}
+			}
+		}
+
+		size_type new_page_size = size + align + header_size;
+		new_page_size           = new_page_size < page_size ? page_size : new_page_size;
+
+		Page* page = reinterpret_cast<Page*>(ByteAllocator().allocate(new_page_size));
+		page->size = new_page_size;
+
+		if (m_current_page)
+		{
+			page->next           = m_current_page->next;
+			m_current_page->next = page;
+		}
+		else
+		{
+			page->next   = m_first_page;
+			m_first_page = page;
+		}
+
+		m_capacity += new_page_size;
+		m_current_page = page;
+		m_cursor       = page_data(page);
+		m_end          = reinterpret_cast<unsigned char*>(page) + new_page_size;
+	}
+
+	void* FrameArena::allocate(size_type size, size_type align)
+	{
+		if (size == 0)
+			size = 1;
+
+		unsigned char* data = align_pointer(m_cursor, align);
+
+		if (m_cursor == nullptr || data + size > m_end)
+		{
+			next_page(size, align);
+			data = align_pointer(m_cursor, align);
+		}
+
+		m_cursor = data + size;
+		m_allocations.store(m_allocations.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+		const size_type usage = used();
+		if (usage > m_peak_usage.load(std::memory_order_relaxed))
+			m_peak_usage.store(usage, std::memory_order_relaxed);
+
+		return data;
+	}
+
+	FrameArena& FrameArena::deallocate(void* ptr, size_type size)
+	{
+		unsigned char* data = reinterpret_cast<unsigned char*>(ptr);
+
+		if (data && data + size == m_cursor)
+		{
+			m_cursor = data;
+		}
+		return *this;
+	}
+
+	FrameArena& FrameArena::reset()
+	{
+		m_current_page  = m_first_page;
+		m_used_in_pages = 0;
+		m_allocations.store(0, std::memory_order_relaxed);
+
+		if (m_current_page)
+		{
+			m_cursor = page_data(m_current_page);
+			m_end    = reinterpret_cast<unsigned char*>(m_current_page) + m_current_page->size;
+		}
+		else
+		{
+			m_cursor = nullptr;
+			m_end    = nullptr;
+		}
+
+		return *this;
+	}
+
+	FrameArena::size_type FrameArena::used() const
+	{
+		if (m_current_page == nullptr)
+			return 0;
+
+		return m_used_in_pages + (m_current_page->size - (m_end - m_cursor));
+	}
+
+	FrameArena::size_type FrameArena::capacity() const
+	{
+		return m_capacity;
+	}
+
+	FrameArena::size_type FrameArena::allocations_count() const
+	{
+		return m_allocations;
+	}
+
+	FrameArena::size_type FrameArena::peak_usage() const
+	{
+		return m_peak_usage;
+	}
+}// namespace Engine
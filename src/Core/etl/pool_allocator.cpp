@@ -0,0 +1,193 @@
+#include <Core/etl/allocator.hpp>
+#include <Core/etl/critical_section.hpp>
+#include <Core/etl/pool_allocator.hpp>
+
+namespace Engine
+{
+	using size_type = PoolAllocator::size_type;
+
+	struct FreeBlock {
+		FreeBlock* next;
+	};
+
+	// Pools are never destroyed, because objects can be deallocated after the static destructors of this file were called
+	struct Pool {
+		CriticalSection section;
+		FreeBlock* free_blocks             = nullptr;
+		unsigned char* slab                = nullptr;
+		unsigned char* slab_end            = nullptr;
+		size_type slabs_count              = 0;
+		Atomic<size_type> allocated_blocks = 0;
+	};
+
+	// Pools must be initialized before any static object of other translation units can be allocated
+	static constinit Pool m_pools[PoolAllocator::size_classes];
+
+	static FORCE_INLINE constexpr size_type block_size_of(size_type size_class)
+	{
+		return (size_class + 1) * PoolAllocator::granularity;
+	}
+
+	// Moves up to count blocks from the shared pool to the list. Returns the number of moved blocks
+	static size_type take_blocks(size_type size_class, FreeBlock*& list, size_type count)
+	{
+		Pool& pool           = m_pools[size_class];
+		const size_type size = block_size_of(size_class);
+		size_type taken      = 0;
+		ScopeLock lock(pool.section);
+
+		while (taken < count && pool.free_blocks)
+		{
+			FreeBlock* block = pool.free_blocks;
+			pool.free_blocks = block->next;
+			block->next      = list;
+			list             = block;
+			++taken;
+		}
+
+		while (taken < count)
+		{
+			if (pool.slab == nullptr || pool.slab + size > pool.slab_end)
+			{
+				pool.slab     = ByteAllocator().allocate(PoolAllocator::slab_size);
+				pool.slab_end = pool.slab + PoolAllocator::slab_size;
+				++pool.slabs_count;
+			}
+
+			FreeBlock* block = reinterpret_cast<FreeBlock*>(pool.slab);
+			pool.slab += size;
+			block->next = list;
+			list        = block;
+			++taken;
+		}
+
+		return taken;
+	}
+
+	static void return_blocks(size_type size_class, FreeBlock* first, FreeBlock* last)
+	{
+		Pool& pool = m_pools[size_class];
+		ScopeLock lock(pool.section);
+		last->next       = pool.free_blocks;
+		pool.free_blocks = first;
+	}
+
+	struct ThreadCache {
+		FreeBlock* blocks[PoolAllocator::size_classes] = {};
+		size_type counts[PoolAllocator::size_classes]  = {};
+
+		~ThreadCache();
+
+		void flush(size_type size_class, size_type count)
+		{
+			FreeBlock* first = blocks[size_class];
+			FreeBlock* last  = first;
+
+			for (size_type i = 1; i < count; ++i)
+			{
+				last = last->next;
+			}
+
+			blocks[size_class] = last->next;
+			counts[size_class] -= count;
+			return_blocks(size_class, first, last);
+		}
+	};
+
+	static thread_local bool m_is_cache_destroyed = false;
+
+	ThreadCache::~ThreadCache()
+	{
+		for (size_type size_class = 0; size_class < PoolAllocator::size_classes; ++size_class)
+		{
+			if (counts[size_class] > 0)
+				flush(size_class, counts[size_class]);
+		}
+
+		m_is_cache_destroyed = true;
+	}
+
+	static FORCE_INLINE ThreadCache* thread_cache()
+	{
+		static thread_local ThreadCache cache;
+
+		if (m_is_cache_destroyed)
+			return nullptr;
+		return &cache;
+	}
+
+	void* PoolAllocator::allocate(size_type size)
+	{
+		if (size > max_block_size)
+			return ByteAllocator().allocate(size);
+
+		const size_type size_class = size_class_of(size);
+		m_pools[size_class].allocated_blocks.fetch_add(1, std::memory_order_relaxed);
+
+		ThreadCache* cache = thread_cache();
+
+		if (cache == nullptr)
+		{
+			FreeBlock* block = nullptr;
+			take_blocks(size_class, block, 1);
+			return block;
+		}
+
+		FreeBlock*& blocks = cache->blocks[size_class];
+
+		if (blocks == nullptr)
+		{
+			cache->counts[size_class] += take_blocks(size_class, blocks, thread_cache_size / 2);
+		}
+
+		FreeBlock* block = blocks;
+		blocks           = block->next;
+		--cache->counts[size_class];
+		return block;
+	}
+
+	void PoolAllocator::deallocate(void* ptr, size_type size)
+	{
+		if (ptr == nullptr)
+			return;
+
+		if (size > max_block_size)
+		{
+			ByteAllocator().deallocate(static_cast<unsigned char*>(ptr), size);
+			return;
+		}
+
+		const size_type size_class = size_class_of(size);
+		m_pools[size_class].allocated_blocks.fetch_sub(1, std::memory_order_relaxed);
+
+		FreeBlock* block   = static_cast<FreeBlock*>(ptr);
+		ThreadCache* cache = thread_cache();
+
+		if (cache == nullptr)
+		{
+			return_blocks(size_class, block, block);
+			return;
+		}
+
+		block->next               = cache->blocks[size_class];
+		cache->blocks[size_class] = block;
+
+		if (++cache->counts[size_class] > thread_cache_size)
+		{
+			cache->flush(size_class, thread_cache_size / 2);
+		}
+	}
+
+	PoolAllocator::Statistics PoolAllocator::statistics(size_type size_class)
+	{
+		Statistics result;
+		Pool& pool = m_pools[size_class];
+
+		result.block_size       = block_size_of(size_class);
+		result.allocated_blocks = pool.allocated_blocks.load(std::memory_order_relaxed);
+
+		ScopeLock lock(pool.section);
+		result.slabs_count = pool.slabs_count;
+		return result;
+	}
+}// namespace Engine
@@ -125,6 +125,13 @@ namespace Engine
 		return m_file != nullptr && m_file->is_open();
 	}
 
+	Span<const byte> FileReader::view()
+	{
+		if (!is_open())
+			return {};
+		return m_file->view();
+	}
+
 	String FileReader::read_string(size_t len)
 	{
 		len = glm::min(len, size());
@@ -10,4 +10,9 @@ namespace Engine::VFS
 		read_position(static_cast<FileOffset>(pos), FileSeekDir::Begin);
 		return size;
 	}
+
+	Span<const byte> File::view() const
+	{
+		return {};
+	}
 }// namespace Engine::VFS
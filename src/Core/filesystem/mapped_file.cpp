@@ -0,0 +1,220 @@
+#include "vfs_log.hpp"
+#include <Core/filesystem/mapped_file.hpp>
+#include <algorithm>
+
+#if PLATFORM_WINDOWS
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Engine::VFS
+{
+	MappedFile::MappedFile() = default;
+
+	MappedFile::MappedFile(const Path& native_path)
+	{
+		open(native_path);
+	}
+
+	MappedFile::~MappedFile()
+	{
+		close();
+	}
+
+	bool MappedFile::open(const Path& native_path)
+	{
+		close();
+
+#if PLATFORM_WINDOWS
+		HANDLE file = CreateFileA(native_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+		                          FILE_ATTRIBUTE_NORMAL, nullptr);
+
+		if (file == INVALID_HANDLE_VALUE)
+			return false;
+
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(file, &size))
+		{
+			CloseHandle(file);
+			return false;
+		}
+
+		m_file    = file;
+		m_size    = static_cast<size_t>(size.QuadPart);
+		m_is_open = true;
+
+		// Empty files cannot be mapped
+		if (m_size == 0)
+			return true;
+
+		m_mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+		if (m_mapping)
+		{
+			m_data = static_cast<const byte*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+		}
+#else
+		int file = ::open(native_path.c_str(), O_RDONLY);
+
+		if (file < 0)
+			return false;
+
+		struct stat status;
+		if (fstat(file, &status) != 0 || !S_ISREG(status.st_mode))
+		{
+			::close(file);
+			return false;
+		}
+
+		m_size    = static_cast<size_t>(status.st_size);
+		m_is_open = true;
+
+		// Empty files cannot be mapped
+		if (m_size == 0)
+		{
+			::close(file);
+			return true;
+		}
+
+		void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+
+		// Mapping keeps the file alive, so descriptor is not needed anymore
+		::close(file);
+
+		if (data != MAP_FAILED)
+		{
+			m_data = static_cast<const byte*>(data);
+		}
+#endif
+
+		if (m_data == nullptr)
+		{
+			vfs_error("Failed to map file '%s'", native_path.c_str());
+			close();
+			return false;
+		}
+
+		return true;
+	}
+
+	MappedFile& MappedFile::close()
+	{
+#if PLATFORM_WINDOWS
+		if (m_data)
+			UnmapViewOfFile(m_data);
+		if (m_mapping)
+			CloseHandle(m_mapping);
+		if (m_file)
+			CloseHandle(m_file);
+
+		m_file    = nullptr;
+		m_mapping = nullptr;
+#else
+		if (m_data)
+			munmap(const_cast<byte*>(m_data), m_size);
+#endif
+
+		m_data    = nullptr;
+		m_size    = 0;
+		m_is_open = false;
+		return *this;
+	}
+
+	bool MappedFile::is_open() const
+	{
+		return m_is_open;
+	}
+
+	const byte* MappedFile::data() const
+	{
+		return m_data;
+	}
+
+	size_t MappedFile::size() const
+	{
+		return m_size;
+	}
+
+	Span<const byte> MappedFile::span(size_t offset, size_t size) const
+	{
+		if (offset >= m_size)
+			return {};
+
+		return Span<const byte>(m_data + offset, glm::min(size, m_size - offset));
+	}
+
+	MappedFileView::MappedFileView(const Path& path, const SharedPtr<MappedFile>& mapping, size_t offset, size_t size)
+	    : m_path(path), m_mapping(mapping), m_view(mapping->span(offset, size))
+	{}
+
+	const Path& MappedFileView::path() const
+	{
+		return m_path;
+	}
+
+	bool MappedFileView::is_read_only() const
+	{
+		return true;
+	}
+
+	void MappedFileView::close()
+	{
+		delete this;
+	}
+
+	bool MappedFileView::is_open() const
+	{
+		return m_mapping && m_mapping->is_open();
+	}
+
+	MappedFileView::FilePosition MappedFileView::read_position(FileOffset offset, FileSeekDir dir)
+	{
+		FileOffset base = 0;
+
+		if (dir == FileSeekDir::Current)
+			base = static_cast<FileOffset>(m_position);
+		else if (dir == FileSeekDir::End)
+			base = static_cast<FileOffset>(m_view.size());
+
+		const FileOffset size = static_cast<FileOffset>(m_view.size());
+		m_position            = static_cast<FilePosition>(glm::clamp<FileOffset>(base + offset, 0, size));
+		return m_position;
+	}
+
+	MappedFileView::FilePosition MappedFileView::read_position()
+	{
+		return m_position;
+	}
+
+	MappedFileView::FilePosition MappedFileView::write_position(FileOffset offset, FileSeekDir dir)
+	{
+		return 0;
+	}
+
+	MappedFileView::FilePosition MappedFileView::write_position()
+	{
+		return 0;
+	}
+
+	size_t MappedFileView::read(byte* buffer, size_t size)
+	{
+		size = glm::min<size_t>(size, m_view.size() - m_position);
+		std::copy_n(m_view.data() + m_position, size, buffer);
+		m_position += size;
+		return size;
+	}
+
+	size_t MappedFileView::write(const byte* buffer, size_t size)
+	{
+		return 0;
+	}
+
+	Span<const byte> MappedFileView::view() const
+	{
+		return m_view;
+	}
+}// namespace Engine::VFS
@@ -1,8 +1,11 @@
 #include "vfs_log.hpp"
+#include <Core/constants.hpp>
 #include <Core/exception.hpp>
 #include <Core/filesystem/directory_iterator.hpp>
+#include <Core/filesystem/mapped_file.hpp>
 #include <Core/filesystem/native_file.hpp>
 #include <Core/filesystem/native_file_system.hpp>
+#include <Core/filesystem/packed_file_system.hpp>
 #include <Core/filesystem/path.hpp>
 #include <Core/logger.hpp>
 #include <cerrno>
@@ -105,6 +108,21 @@ namespace Engine::VFS
 	}
 
 
+	// Mapping costs a system call and at least one page, so it pays off only for large files which are read by views
+	static constexpr inline size_t min_mapped_file_size = 64 * 1024;
+
+	static bool is_mapped_file(const Path& path)
+	{
+		const StringView extension = path.extension();
+
+		if (extension != Constants::asset_extention && extension != PackedFileSystem::extension)
+			return false;
+
+		std::error_code code;
+		const auto size = fs::file_size(path.str(), code);
+		return !code && size >= min_mapped_file_size;
+	}
+
 	NativeFileSystem::NativeFileSystem(const Path& directory) : m_path(directory)
 	{
 		trinex_always_check(fs::is_directory(directory.str()), "Path to native file system must be directory!");
@@ -131,6 +149,15 @@ namespace Engine::VFS
 		bool is_read_only                 = !mode.has_any(Flags(FlagsOperator::Or, FileOpenMode::Out, FileOpenMode::Append));
 
 
+		// Large assets and packs which are only read are mapped into memory, other files use the stream
+		if (is_read_only && is_mapped_file(full_path))
+		{
+			auto mapping = std::make_shared<MappedFile>(full_path);
+
+			if (mapping->is_open())
+				return new MappedFileView(path, mapping, 0, mapping->size());
+		}
+
 		if (mode & FileOpenMode::In)
 			open_mode |= std::ios_base::in;
 		if (mode & FileOpenMode::Out)
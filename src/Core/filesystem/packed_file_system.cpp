@@ -0,0 +1,536 @@
+#include "vfs_log.hpp"
+#include <Core/etl/set.hpp>
+#include <Core/filesystem/directory_iterator.hpp>
+#include <Core/filesystem/file.hpp>
+#include <Core/filesystem/mapped_file.hpp>
+#include <Core/filesystem/packed_file_system.hpp>
+#include <Core/memory.hpp>
+#include <Engine/settings.hpp>
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <lz4hc.h>
+
+namespace Engine::VFS
+{
+	namespace fs = std::filesystem;
+
+	// Compressed data of the packed file is decompressed into memory on open
+	class PackedFile final : public File
+	{
+	private:
+		Path m_path;
+		Buffer m_data;
+		FilePosition m_position = 0;
+
+	public:
+		PackedFile(const Path& path, Buffer&& data) : m_path(path), m_data(std::move(data))
+		{}
+
+		const Path& path() const override
+		{
+			return m_path;
+		}
+
+		bool is_read_only() const override
+		{
+			return true;
+		}
+
+		void close() override
+		{
+			delete this;
+		}
+
+		bool is_open() const override
+		{
+			return true;
+		}
+
+		FilePosition read_position(FileOffset offset, FileSeekDir dir) override
+		{
+			FileOffset base = 0;
+
+			if (dir == FileSeekDir::Current)
+				base = static_cast<FileOffset>(m_position);
+			else if (dir == FileSeekDir::End)
+				base = static_cast<FileOffset>(m_data.size());
+
+			const FileOffset size = static_cast<FileOffset>(m_data.size());
+			m_position            = static_cast<FilePosition>(glm::clamp<FileOffset>(base + offset, 0, size));
+			return m_position;
+		}
+
+		FilePosition read_position() override
+		{
+			return m_position;
+		}
+
+		FilePosition write_position(FileOffset offset, FileSeekDir dir) override
+		{
+			return 0;
+		}
+
+		FilePosition write_position() override
+		{
+			return 0;
+		}
+
+		size_t read(byte* buffer, size_t size) override
+		{
+			size = glm::min<size_t>(size, m_data.size() - m_position);
+			std::copy_n(m_data.data() + m_position, size, buffer);
+			m_position += size;
+			return size;
+		}
+
+		size_t write(const byte* buffer, size_t size) override
+		{
+			return 0;
+		}
+
+		Span<const byte> view() const override
+		{
+			return m_data;
+		}
+	};
+
+	struct PackedIterator : public DirectoryIteratorInterface {
+		Vector<Path> m_paths;
+		size_t m_index = 0;
+
+		void next() override
+		{
+			++m_index;
+		}
+
+		const Path& path() override
+		{
+			return m_paths[m_index];
+		}
+
+		bool is_valid() const override
+		{
+			return m_index < m_paths.size();
+		}
+
+		DirectoryIteratorInterface* copy() override
+		{
+			return new PackedIterator(*this);
+		}
+
+		Type type() const override
+		{
+			return Virtual;
+		}
+
+		bool is_equal(DirectoryIteratorInterface* other) override
+		{
+			PackedIterator* iterator = static_cast<PackedIterator*>(other);
+			return m_index == iterator->m_index &&
+			       std::equal(m_paths.begin(), m_paths.end(), iterator->m_paths.begin(), iterator->m_paths.end());
+		}
+	};
+
+	// Paths in the table of contents are relative and have no leading or trailing separators
+	static StringView normalize_path(const Path& path)
+	{
+		StringView view = path.str();
+
+		while (!view.empty() && view.front() == Path::separator) view.remove_prefix(1);
+		while (!view.empty() && view.back() == Path::separator) view.remove_suffix(1);
+		return view;
+	}
+
+	static FORCE_INLINE bool is_child_of(StringView path, StringView directory, bool recursive)
+	{
+		if (!directory.empty())
+		{
+			if (path.size() <= directory.size() || !path.starts_with(directory) || path[directory.size()] != Path::separator)
+				return false;
+
+			path.remove_prefix(directory.size() + 1);
+		}
+
+		return recursive || path.find(Path::separator) == StringView::npos;
+	}
+
+	template<typename Type>
+	static FORCE_INLINE bool read_value(Span<const byte>& data, Type& value)
+	{
+		if (data.size() < sizeof(Type))
+			return false;
+
+		std::memcpy(&value, data.data(), sizeof(Type));
+		data = data.subspan(sizeof(Type));
+		return true;
+	}
+
+	template<typename Type>
+	static FORCE_INLINE void write_value(std::ostream& stream, const Type& value)
+	{
+		stream.write(reinterpret_cast<const char*>(&value), sizeof(Type));
+	}
+
+	static void write_padding(std::ostream& stream, uint64_t alignment)
+	{
+		static const char zeros[4096] = {};
+		uint64_t position             = static_cast<uint64_t>(stream.tellp());
+		uint64_t padding              = (alignment - position % alignment) % alignment;
+
+		while (padding > 0)
+		{
+			const uint64_t size = glm::min<uint64_t>(padding, sizeof(zeros));
+			stream.write(zeros, static_cast<std::streamsize>(size));
+			padding -= size;
+		}
+	}
+
+	PackedFileSystem::PackedFileSystem(const Path& pack) : m_path(pack)
+	{
+		m_mapping = std::make_shared<MappedFile>(pack);
+
+		if (!m_mapping->is_open())
+		{
+			vfs_error("Failed to open pack file '%s'", pack.c_str());
+			m_mapping.reset();
+			return;
+		}
+
+		Span<const byte> data = m_mapping->span(0, m_mapping->size());
+		Header header;
+
+		if (!read_value(data, header) || header.magic != magic || header.version != version)
+		{
+			vfs_error("File '%s' is not a valid pack file", pack.c_str());
+			m_mapping.reset();
+			return;
+		}
+
+		Span<const byte> toc = m_mapping->span(header.toc_offset, header.toc_size);
+		m_entries.resize(header.entries_count);
+
+		Set<String> directories;
+		String entry_path;
+
+		for (Entry& entry : m_entries)
+		{
+			uint32_t path_length = 0;
+
+			bool status = read_value(toc, entry.offset) && read_value(toc, entry.size) && read_value(toc, entry.original_size) &&
+			              read_value(toc, entry.hash) && read_value(toc, entry.flags) && read_value(toc, path_length);
+
+			if (!status || toc.size() < path_length || entry.offset + entry.size > m_mapping->size())
+			{
+				vfs_error("Table of contents of the pack file '%s' is corrupted", pack.c_str());
+				m_entries.clear();
+				m_mapping.reset();
+				return;
+			}
+
+			entry_path.assign(reinterpret_cast<const char*>(toc.data()), path_length);
+			toc        = toc.subspan(path_length);
+			entry.path = entry_path;
+
+			for (size_t position = entry_path.find(Path::separator); position != String::npos;
+			     position        = entry_path.find(Path::separator, position + 1))
+			{
+				directories.insert(entry_path.substr(0, position));
+			}
+		}
+
+		m_directories.reserve(directories.size());
+
+		for (const String& directory : directories)
+		{
+			m_directories.emplace_back(directory);
+		}
+
+		std::sort(m_directories.begin(), m_directories.end());
+	}
+
+	const PackedFileSystem::Entry* PackedFileSystem::find_entry(const Path& path) const
+	{
+		StringView name = normalize_path(path);
+
+		auto it = std::lower_bound(m_entries.begin(), m_entries.end(), name,
+		                           [](const Entry& entry, StringView name) { return StringView(entry.path.str()) < name; });
+
+		if (it != m_entries.end() && it->path.str() == name)
+			return &*it;
+		return nullptr;
+	}
+
+	bool PackedFileSystem::is_directory_entry(const Path& path) const
+	{
+		StringView name = normalize_path(path);
+
+		if (name.empty())
+			return true;
+
+		auto it = std::lower_bound(m_directories.begin(), m_directories.end(), name,
+		                           [](const Path& directory, StringView name) { return StringView(directory.str()) < name; });
+		return it != m_directories.end() && it->str() == name;
+	}
+
+	DirectoryIteratorInterface* PackedFileSystem::create_iterator(const Path& path, bool recursive)
+	{
+		if (!is_directory_entry(path))
+			return nullptr;
+
+		StringView directory     = normalize_path(path);
+		PackedIterator* iterator = new PackedIterator();
+
+		for (const Path& entry : m_directories)
+		{
+			if (is_child_of(entry.str(), directory, recursive))
+				iterator->m_paths.push_back(m_mount_point / entry);
+		}
+
+		for (const Entry& entry : m_entries)
+		{
+			if (is_child_of(entry.path.str(), directory, recursive))
+				iterator->m_paths.push_back(m_mount_point / entry.path);
+		}
+
+		return iterator;
+	}
+
+	DirectoryIteratorInterface* PackedFileSystem::create_directory_iterator(const Path& path)
+	{
+		return create_iterator(path, false);
+	}
+
+	DirectoryIteratorInterface* PackedFileSystem::create_recursive_directory_iterator(const Path& path)
+	{
+		return create_iterator(path, true);
+	}
+
+	bool PackedFileSystem::pack(const Path& native_folder, const Path& output, bool compress)
+	{
+		std::error_code code;
+
+		if (!fs::is_directory(native_folder.str(), code))
+		{
+			vfs_error("Failed to pack '%s'. Path is not a directory!", native_folder.c_str());
+			return false;
+		}
+
+		Vector<Entry> entries;
+		const fs::path root = native_folder.str();
+
+		for (auto& file : fs::recursive_directory_iterator(root, code))
+		{
+			if (file.is_regular_file())
+			{
+				Entry entry = {};
+				entry.path  = fs::relative(file.path(), root).generic_string();
+				entries.push_back(entry);
+			}
+		}
+
+		std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.path < b.path; });
+
+		std::ofstream stream(output.str(), std::ios_base::binary | std::ios_base::out | std::ios_base::trunc);
+
+		if (!stream.is_open())
+		{
+			vfs_error("Failed to create pack file '%s'", output.c_str());
+			return false;
+		}
+
+		// Header is written after the table of contents, when all offsets are known
+		Header header = {};
+		write_value(stream, header);
+
+		Buffer data;
+		Buffer compressed;
+
+		for (Entry& entry : entries)
+		{
+			std::ifstream file((root / entry.path.str()).string(), std::ios_base::binary | std::ios_base::ate);
+
+			if (!file.is_open())
+			{
+				vfs_error("Failed to open file '%s'", entry.path.c_str());
+				return false;
+			}
+
+			data.resize(static_cast<size_t>(file.tellg()));
+			file.seekg(0);
+			file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+
+			entry.original_size = data.size();
+			entry.size          = data.size();
+			entry.hash          = memory_hash_fast(data.data(), data.size(), 0);
+			entry.flags         = Hashed;
+
+			const Buffer* content = &data;
+
+			if (compress && !data.empty())
+			{
+				const int bound = LZ4_compressBound(static_cast<int>(data.size()));
+				compressed.resize(bound);
+
+				const int size = LZ4_compress_HC(reinterpret_cast<const char*>(data.data()),
+				                                 reinterpret_cast<char*>(compressed.data()), static_cast<int>(data.size()),
+				                                 bound, Settings::lz4_compression_level);
+
+				// Compression is used only if it saves at least an eighth of the entry size
+				if (size > 0 && static_cast<uint64_t>(size) < data.size() - data.size() / 8)
+				{
+					compressed.resize(size);
+					content    = &compressed;
+					entry.size = compressed.size();
+					entry.flags |= Compressed;
+				}
+			}
+
+			write_padding(stream, alignment);
+			entry.offset = static_cast<uint64_t>(stream.tellp());
+			stream.write(reinterpret_cast<const char*>(content->data()), static_cast<std::streamsize>(content->size()));
+		}
+
+		header.magic         = magic;
+		header.version       = version;
+		header.entries_count = static_cast<uint32_t>(entries.size());
+		header.toc_offset    = static_cast<uint64_t>(stream.tellp());
+
+		for (const Entry& entry : entries)
+		{
+			write_value(stream, entry.offset);
+			write_value(stream, entry.size);
+			write_value(stream, entry.original_size);
+			write_value(stream, entry.hash);
+			write_value(stream, entry.flags);
+			write_value(stream, static_cast<uint32_t>(entry.path.length()));
+			stream.write(entry.path.c_str(), static_cast<std::streamsize>(entry.path.length()));
+		}
+
+		header.toc_size = static_cast<uint64_t>(stream.tellp()) - header.toc_offset;
+		stream.seekp(0);
+		write_value(stream, header);
+
+		if (!stream)
+		{
+			vfs_error("Failed to write pack file '%s'", output.c_str());
+			return false;
+		}
+
+		vfs_log("Packed %zu files from '%s' to '%s'", entries.size(), native_folder.c_str(), output.c_str());
+		return true;
+	}
+
+	bool PackedFileSystem::is_valid() const
+	{
+		return m_mapping != nullptr;
+	}
+
+	const Vector<PackedFileSystem::Entry>& PackedFileSystem::entries() const
+	{
+		return m_entries;
+	}
+
+	const Path& PackedFileSystem::path() const
+	{
+		return m_path;
+	}
+
+	Path PackedFileSystem::native_path(const Path& path) const
+	{
+		return {};
+	}
+
+	bool PackedFileSystem::is_read_only() const
+	{
+		return true;
+	}
+
+	File* PackedFileSystem::open(const Path& path, Flags<FileOpenMode> mode)
+	{
+		if ((mode & FileOpenMode::Out) || (mode & FileOpenMode::Append) || (mode & FileOpenMode::Trunc))
+		{
+			vfs_error("%s: Packed file system is read only", path.c_str());
+			return nullptr;
+		}
+
+		const Entry* entry = find_entry(path);
+
+		if (entry == nullptr)
+			return nullptr;
+
+		Span<const byte> data = m_mapping->span(entry->offset, entry->size);
+
+		// Uncompressed entries are read directly from the mapped pages
+		if (!(entry->flags & Compressed))
+		{
+			if ((entry->flags & Hashed) && memory_hash_fast(data.data(), data.size(), 0) != entry->hash)
+			{
+				vfs_error("%s: Hash of the packed file mismatch", path.c_str());
+				return nullptr;
+			}
+
+			return new MappedFileView(path, m_mapping, entry->offset, entry->size);
+		}
+
+		Buffer original(entry->original_size);
+
+		const int size = LZ4_decompress_safe(reinterpret_cast<const char*>(data.data()), reinterpret_cast<char*>(original.data()),
+		                                     static_cast<int>(data.size()), static_cast<int>(original.size()));
+
+		if (size < 0 || static_cast<uint64_t>(size) != entry->original_size)
+		{
+			vfs_error("%s: Failed to decompress packed file", path.c_str());
+			return nullptr;
+		}
+
+		if ((entry->flags & Hashed) && memory_hash_fast(original.data(), original.size(), 0) != entry->hash)
+		{
+			vfs_error("%s: Hash of the packed file mismatch", path.c_str());
+			return nullptr;
+		}
+
+		return new PackedFile(path, std::move(original));
+	}
+
+	bool PackedFileSystem::create_dir(const Path& path)
+	{
+		return false;
+	}
+
+	bool PackedFileSystem::remove(const Path& path)
+	{
+		return false;
+	}
+
+	bool PackedFileSystem::copy(const Path& src, const Path& dest)
+	{
+		return false;
+	}
+
+	bool PackedFileSystem::rename(const Path& src, const Path& dest)
+	{
+		return false;
+	}
+
+	bool PackedFileSystem::is_file_exist(const Path& path) const
+	{
+		return find_entry(path) != nullptr || is_directory_entry(path);
+	}
+
+	bool PackedFileSystem::is_file(const Path& file) const
+	{
+		return find_entry(file) != nullptr;
+	}
+
+	bool PackedFileSystem::is_dir(const Path& dir) const
+	{
+		return is_directory_entry(dir);
+	}
+
+	PackedFileSystem::Type PackedFileSystem::type() const
+	{
+		return Type::Virtual;
+	}
+}// namespace Engine::VFS
@@ -1,5 +1,6 @@
 #include "vfs_log.hpp"
 #include <Core/filesystem/native_file_system.hpp>
+#include <Core/filesystem/packed_file_system.hpp>
 #include <Core/filesystem/path.hpp>
 #include <Core/filesystem/root_filesystem.hpp>
 #include <Core/logger.hpp>
@@ -251,6 +252,16 @@ namespace Engine::VFS
 		return fs->type();
 	}
 
+	bool RootFS::pack_native_folder(const Path& native, const Path& virtual_fs, const StringView& password) const
+	{
+		if (!password.empty())
+		{
+			vfs_warning("Encryption of the packed file systems is not supported, password is ignored");
+		}
+
+		return PackedFileSystem::pack(native, virtual_fs);
+	}
+
 	Vector<String> RootFS::mount_points() const
 	{
 		Vector<String> result;
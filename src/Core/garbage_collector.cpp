@@ -1,44 +1,59 @@
 #include <Core/base_engine.hpp>
+#include <Core/etl/critical_section.hpp>
+#include <Core/etl/pool_allocator.hpp>
 #include <Core/garbage_collector.hpp>
 #include <Core/logger.hpp>
 #include <Core/object.hpp>
 #include <Core/package.hpp>
+#include <Core/parallel.hpp>
 #include <Core/reflection/class.hpp>
 #include <Core/reflection/property.hpp>
+#include <Core/thread_manager.hpp>
+#include <Core/threading.hpp>
 #include <Engine/settings.hpp>
-
-#define DISABLE_GC 1
+#include <chrono>
 
 namespace Engine
 {
+	// Objects are colored using IsUnreachable flag. White objects have this flag, grey objects have no flag and are stored in
+	// the worklist, black objects have no flag and were already traced
 	enum GCStage : EnumerateType
 	{
-		MarkUnreachable   = 0,
-		CollectingGarbage = 1,
-		DestroyGarbage    = 2,
+		Idle           = 0,
+		ScanRoots      = 1,
+		Mark           = 2,
+		Sweep          = 3,
+		DestroyGarbage = 4,
+	};
 
-		FirstStage = MarkUnreachable,
-		LastStage  = DestroyGarbage
+	// Objects can be destroyed while they are waiting in the lists, so the handle is used to check that object is still alive
+	struct GCEntry {
+		Object* object;
+		ObjectHandle handle;
 	};
 
 	static struct GCState {
-		Index object_index = 0;
-		GCStage stage      = GCStage::MarkUnreachable;
+		Index object_index     = 0;
+		GCStage stage          = GCStage::Idle;
+		Atomic<bool> is_active = false;
+
+		Vector<GCEntry> worklist;
+		Vector<GCEntry> mark_slice;
+		Vector<GCEntry> garbage;
+		size_t traced_objects = 0;
+		Vector<Object*> sweep_objects;
+		JobHandle sweep_job;
+
+		CriticalSection barrier_section;
+		Vector<GCEntry> barrier_queue;
 	} gc_state;
 
 	CallBacks<void(Object*)> GarbageCollector::on_unreachable_check;
 	CallBacks<void(Object*)> GarbageCollector::on_destroy;
 
-	static FORCE_INLINE ByteAllocator& allocator()
-	{
-		static ByteAllocator object_allocator;
-		return object_allocator;
-	}
-
 	void* Object::operator new(size_t size) noexcept
 	{
-		byte* memory = allocator().allocate(size);
-		return memory;
+		return PoolAllocator::allocate(size);
 	}
 
 	ENGINE_EXPORT void* Object::operator new(size_t size, void* place) noexcept
@@ -48,15 +63,318 @@ namespace Engine
 
 	void Object::operator delete(void* _memory, size_t size) noexcept
 	{
-		byte* memory = reinterpret_cast<byte*>(_memory);
-		allocator().deallocate(memory, size);
+		PoolAllocator::deallocate(_memory, size);
+	}
+
+	class GCBudget
+	{
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		Clock::time_point m_deadline;
+
+		GCBudget(Clock::time_point deadline) : m_deadline(deadline)
+		{}
+
+	public:
+		GCBudget() : m_deadline(Clock::now() + std::chrono::microseconds(glm::max<int_t>(1, Settings::gc_tick_budget)))
+		{}
+
+		static GCBudget unlimited()
+		{
+			return GCBudget(Clock::time_point::max());
+		}
+
+		bool is_exceeded() const
+		{
+			return Clock::now() >= m_deadline;
+		}
+	};
+
+	// Work is split into slices, time budget is checked between them
+	static constexpr size_t gc_slice_per_thread = 256;
+
+	using GCScratch = ParallelScratch<Vector<GCEntry>>;
+
+	static FORCE_INLINE size_t gc_slice_size()
+	{
+		return Parallel::threads_count() * gc_slice_per_thread;
+	}
+
+	static FORCE_INLINE bool is_alive(const GCEntry& entry)
+	{
+		return Object::object_of(entry.handle) == entry.object;
+	}
+
+	static FORCE_INLINE bool is_root(Object* object)
+	{
+		return object->flags(Object::StandAlone) || !object->flags(Object::IsAvailableForGC) || object->references() > 0 ||
+		       object->owner() != nullptr;
+	}
+
+	// Clearing of the flag is atomic, so only one thread can push the object to the worklist
+	static FORCE_INLINE void shade(Object* object, Vector<GCEntry>& worklist)
+	{
+		if (object && object->flags.exchange_remove(Object::IsUnreachable))
+		{
+			worklist.push_back({object, object->handle()});
+		}
+	}
+
+	static void trace_struct(Refl::Struct* self, void* context, Vector<GCEntry>& worklist);
+
+	static void trace_property(Refl::Property* prop, void* context, Vector<GCEntry>& worklist)
+	{
+		if (auto object_prop = Refl::Object::instance_cast<Refl::ObjectProperty>(prop))
+		{
+			shade(object_prop->object(context), worklist);
+		}
+		else if (auto struct_prop = Refl::Object::instance_cast<Refl::StructProperty>(prop))
+		{
+			trace_struct(struct_prop->struct_instance(), struct_prop->address(context), worklist);
+		}
+		else if (auto array_prop = Refl::Object::instance_cast<Refl::ArrayProperty>(prop))
+		{
+			Refl::Property* element_prop = array_prop->element_property();
+
+			for (size_t i = 0, count = array_prop->length(context); i < count; ++i)
+			{
+				trace_property(element_prop, array_prop->at(context, i), worklist);
+			}
+		}
+	}
+
+	static void trace_struct(Refl::Struct* self, void* context, Vector<GCEntry>& worklist)
+	{
+		for (; self; self = self->parent())
+		{
+			for (Refl::Property* prop : self->properties())
+			{
+				if (prop)
+				{
+					trace_property(prop, context, worklist);
+				}
+			}
+		}
+	}
+
+	static void merge_scratch(GCScratch& scratch)
+	{
+		scratch.for_each([](Vector<GCEntry>& entries) {
+			gc_state.worklist.insert(gc_state.worklist.end(), entries.begin(), entries.end());
+			entries.clear();
+		});
+	}
+
+	static void flush_barrier_queue()
+	{
+		ScopeLock lock(gc_state.barrier_section);
+
+		for (const GCEntry& entry : gc_state.barrier_queue)
+		{
+			if (is_alive(entry))
+			{
+				shade(entry.object, gc_state.worklist);
+			}
+		}
+
+		gc_state.barrier_queue.clear();
+	}
+
+	static void begin_cycle()
+	{
+		// Whitening touches only flags of each object, so whole array can be processed by worker threads in one tick
+		const auto& objects = Object::all_objects();
+
+		parallel_for(objects.size(), 0, [&objects](size_t index) {
+			if (Object* object = objects[index])
+			{
+				object->flags(Object::Flag::IsUnreachable, true);
+			}
+		});
+
+		gc_state.object_index   = objects.size();
+		gc_state.traced_objects = 0;
+		gc_state.is_active      = true;
+		gc_state.stage          = GCStage::ScanRoots;
+	}
+
+	static FORCE_INLINE void scan_root(Object* object, Vector<GCEntry>& worklist)
+	{
+		if (object == nullptr || !object->flags(Object::IsUnreachable))
+			return;
+
+		if (is_root(object))
+		{
+			shade(object, worklist);
+		}
+		else if (!object->flags(Object::IsUnreachable))
+		{
+			worklist.push_back({object, object->handle()});
+		}
+	}
+
+	static bool scan_roots(const GCBudget& budget)
+	{
+		const auto& objects = Object::all_objects();
+		const size_t slice  = gc_slice_size();
+		GCScratch scratch;
+
+		// Objects are scanned from the end of the array. Destroyed object is replaced by the last object, so objects which
+		// were not scanned yet never move above the scan position. Objects created during the cycle are traced separately
+		while (gc_state.object_index > 0)
+		{
+			if (budget.is_exceeded())
+				return false;
+
+			const size_t end   = glm::min<size_t>(gc_state.object_index, objects.size());
+			const size_t begin = end > slice ? end - slice : 0;
+
+			// Callbacks can keep the object alive by clearing its unreachable flag. They are not required to be thread safe,
+			// so they are called from the logic thread before the slice is scanned by the workers
+			if (!GarbageCollector::on_unreachable_check.empty())
+			{
+				for (size_t index = begin; index < end; ++index)
+				{
+					Object* object = objects[index];
+
+					if (object && object->flags(Object::IsUnreachable))
+					{
+						GarbageCollector::on_unreachable_check(object);
+					}
+				}
+			}
+
+			parallel_for(begin, end, 0, [&](size_t chunk_begin, size_t chunk_end, size_t slot) {
+				Vector<GCEntry>& worklist = scratch[slot];
+
+				for (size_t index = chunk_begin; index < chunk_end; ++index)
+				{
+					scan_root(objects[index], worklist);
+				}
+			});
+
+			gc_state.object_index = begin;
+			merge_scratch(scratch);
+		}
+
+		return true;
+	}
+
+	static bool mark(const GCBudget& budget)
+	{
+		flush_barrier_queue();
+
+		const size_t slice = gc_slice_size();
+		auto& worklist     = gc_state.worklist;
+		auto& entries      = gc_state.mark_slice;
+		GCScratch scratch;
+
+		while (!worklist.empty())
+		{
+			if (budget.is_exceeded())
+				return false;
+
+			// Objects are taken from the end of the worklist, so marking is closer to the depth first order
+			const size_t count = glm::min(slice, worklist.size());
+			entries.assign(worklist.end() - count, worklist.end());
+			worklist.resize(worklist.size() - count);
+
+			parallel_for(count, 0, [&](size_t chunk_begin, size_t chunk_end, size_t slot) {
+				Vector<GCEntry>& local = scratch[slot];
+
+				for (size_t index = chunk_begin; index < chunk_end; ++index)
+				{
+					const GCEntry& entry = entries[index];
+
+					if (is_alive(entry))
+					{
+						trace_struct(entry.object->class_instance(), entry.object, local);
+					}
+				}
+			});
+
+			gc_state.traced_objects += count;
+			merge_scratch(scratch);
+		}
+
+		return true;
 	}
 
-	static FORCE_INLINE uint32_t get_max_objects_per_tick()
+	static void start_sweep()
 	{
-		return glm::max<uint32_t>(1, Settings::gc_max_object_per_tick);
+		gc_state.sweep_objects = Object::all_objects();
+		gc_state.garbage.clear();
+
+		// Sweep job only reads flags. Objects cannot be destroyed while it is running, see GarbageCollector::wait_for_sweep
+		gc_state.sweep_job = ThreadManager::instance()->call_function([]() {
+			const auto& objects = gc_state.sweep_objects;
+
+			for (Index index = 0, count = objects.size(); index < count; ++index)
+			{
+				Object* object = objects[index];
+
+				if (object && object->flags(Object::IsUnreachable))
+				{
+					gc_state.garbage.push_back({object, object->handle()});
+				}
+			}
+		});
+
+		gc_state.stage = GCStage::Sweep;
+	}
+
+	static bool destroy_garbage(const GCBudget& budget)
+	{
+		// Objects which were shaded by write barriers must be traced before anything is destroyed
+		if (!mark(budget))
+			return false;
+
+		while (gc_state.object_index < gc_state.garbage.size())
+		{
+			if (budget.is_exceeded())
+				return false;
+
+			// Destroyed objects can store references to other objects in their destructors
+			if (!gc_state.worklist.empty() && !mark(budget))
+				return false;
+
+			const GCEntry& entry = gc_state.garbage[gc_state.object_index++];
+
+			if (!is_alive(entry))
+				continue;
+
+			Object* object = entry.object;
+
+			if (!object->flags(Object::IsUnreachable))
+				continue;
+
+			if (is_root(object))
+			{
+				shade(object, gc_state.worklist);
+				continue;
+			}
+
+			GarbageCollector::destroy(object);
+		}
+
+		return true;
 	}
 
+	static void finish_cycle()
+	{
+		gc_state.is_active    = false;
+		gc_state.stage        = GCStage::Idle;
+		gc_state.object_index = 0;
+
+		gc_state.worklist.clear();
+		gc_state.mark_slice.clear();
+		gc_state.garbage.clear();
+		gc_state.sweep_objects.clear();
+
+		ScopeLock lock(gc_state.barrier_section);
+		gc_state.barrier_queue.clear();
+	}
 
 	void GarbageCollector::destroy_recursive(Object* object, bool destroy_owner_if_exist)
 	{
@@ -84,6 +402,8 @@ namespace Engine
 		if (object == nullptr)
 			return;
 
+		wait_for_sweep();
+
 		if (engine_instance && !engine_instance->is_shuting_down())
 		{
 			if (!object->is_noname())
@@ -107,127 +427,117 @@ namespace Engine
 		if (Object::all_objects().empty())
 			return;
 
-		if (gc_state.stage == GCStage::MarkUnreachable)
+		GCBudget budget;
+
+		if (gc_state.stage == GCStage::Idle)
 		{
-			mark_unreachable(dt);
+			begin_cycle();
 		}
-		else if (gc_state.stage == GCStage::CollectingGarbage)
+
+		if (gc_state.stage == GCStage::ScanRoots)
 		{
-			collect_garbage(dt);
+			if (!scan_roots(budget))
+				return;
+
+			gc_state.stage = GCStage::Mark;
 		}
-		else if (gc_state.stage == GCStage::DestroyGarbage)
+
+		if (gc_state.stage == GCStage::Mark)
 		{
-			destroy_garbage(dt);
+			if (!mark(budget))
+				return;
+
+			start_sweep();
 		}
-	}
 
-	void GarbageCollector::submit_current_stage()
-	{
-		gc_state.object_index = 0;
+		if (gc_state.stage == GCStage::Sweep)
+		{
+			if (!gc_state.sweep_job.is_finished())
+				return;
 
-		EnumerateType value = gc_state.stage + 1;
-		if (value > LastStage)
+			gc_state.sweep_job.reset();
+			gc_state.sweep_objects.clear();
+			gc_state.object_index = 0;
+			gc_state.stage        = GCStage::DestroyGarbage;
+		}
+
+		if (gc_state.stage == GCStage::DestroyGarbage)
 		{
-			value = FirstStage;
+			if (!destroy_garbage(budget))
+				return;
+
+			finish_cycle();
 		}
-		gc_state.stage = static_cast<GCStage>(value);
 	}
 
-	bool GarbageCollector::process_objects(void (*callback)(Object* object))
+	void GarbageCollector::write_barrier(Object* object)
 	{
-		const auto& objects     = Object::all_objects();
-		uint_t objects_per_tick = get_max_objects_per_tick();
-		auto objects_count      = objects.size();
+		if (object == nullptr || !gc_state.is_active.load(std::memory_order_relaxed))
+			return;
 
-		while (objects_per_tick > 0 && gc_state.object_index < objects_count)
+		if (is_in_logic_thread())
 		{
-			Object* object = objects[gc_state.object_index];
-
-			if (object)
-			{
-				--objects_per_tick;
-				callback(object);
-			}
-
-			++gc_state.object_index;
+			shade(object, gc_state.worklist);
 		}
-
-		if (gc_state.object_index == objects_count)
+		else
 		{
-			submit_current_stage();
-			return true;
+			ScopeLock lock(gc_state.barrier_section);
+			gc_state.barrier_queue.push_back({object, object->handle()});
 		}
-		return false;
 	}
 
-	void GarbageCollector::mark_unreachable(float dt)
+	void GarbageCollector::on_object_created(Object* object)
 	{
-		static void (*callback)(Object* object) = [](Object* object) { object->flags(Object::Flag::IsUnreachable, true); };
-		process_objects(callback);
+		// New objects are not white, but they must be traced, because references stored in them have no barriers
+		if (gc_state.is_active.load(std::memory_order_relaxed))
+		{
+			gc_state.worklist.push_back({object, object->handle()});
+		}
 	}
 
-	static void find_unreachable(Object* object)
+	size_t GarbageCollector::mark_all()
 	{
-		GarbageCollector::on_unreachable_check(object);
+		wait_for_sweep();
+		gc_state.sweep_job.reset();
+		finish_cycle();
 
-		auto& flags = object->flags;
+		GCBudget budget = GCBudget::unlimited();
 
-		if (flags(Object::StandAlone) || object->references() > 0 || object->owner() != nullptr)
-		{
-			object->flags(Object::IsUnreachable, false);
-		}
-
-		if (!object->flags(Object::IsUnreachable))
-		{
-			Refl::Class* class_instance = object->class_instance();
-
-			if (class_instance)
-			{
-				for (auto& prop : class_instance->properties())
-				{
-					if (!prop)
-					{
-						continue;
-					}
+		begin_cycle();
+		scan_roots(budget);
+		gc_state.stage = GCStage::Mark;
+		mark(budget);
 
-					if (auto object_prop = Refl::Object::instance_cast<Refl::ObjectProperty>(prop))
-					{
-						Object* prop_object = object_prop->object(object);
-						if (prop_object)
-						{
-							prop_object->flags(Object::IsUnreachable, false);
-						}
-					}
-				}
-			}
-		}
+		// Sweep and destruction of garbage are performed by the following updates
+		return gc_state.traced_objects;
 	}
 
-
-	void GarbageCollector::collect_garbage(float dt)
+	void GarbageCollector::wait_for_sweep()
 	{
-		process_objects(find_unreachable);
+		if (gc_state.sweep_job)
+		{
+			ThreadManager::instance()->wait(gc_state.sweep_job);
+		}
 	}
 
-	void GarbageCollector::destroy_garbage(float dt)
+	void GarbageCollector::destroy_all_objects()
 	{
-		static void (*callback)(Object* object) = [](Object* object) {
-			if (object->flags(Object::Flag::IsUnreachable))
-			{
-				destroy(object);
-			}
-		};
+		wait_for_sweep();
+		gc_state.sweep_job.reset();
+		finish_cycle();
 
-		process_objects(callback);
-	}
+		// Destruction of the object changes the order of all_objects array, so objects are found by handles
+		Vector<ObjectHandle> handles;
+		handles.reserve(Object::all_objects().size());
 
-	void GarbageCollector::destroy_all_objects()
-	{
-		auto& objects = const_cast<Vector<Object*>&>(Object::all_objects());
+		for (Object* object : Object::all_objects())
+		{
+			handles.push_back(object->handle());
+		}
 
-		for (Object* object : objects)
+		for (const ObjectHandle& handle : handles)
 		{
-			destroy_recursive(object, true);
+			destroy_recursive(Object::object_of(handle), true);
 		}
 	}
 }// namespace Engine
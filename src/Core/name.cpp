@@ -1,8 +1,10 @@
 #include <Core/archive.hpp>
 #include <Core/constants.hpp>
 #include <Core/engine_loading_controllers.hpp>
-#include <Core/etl/map.hpp>
+#include <Core/etl/atomic.hpp>
+#include <Core/etl/critical_section.hpp>
 #include <Core/etl/templates.hpp>
+#include <Core/exception.hpp>
 #include <Core/memory.hpp>
 #include <Core/name.hpp>
 #include <ScriptEngine/registrar.hpp>
@@ -30,16 +32,37 @@ namespace Engine
 	declare_name(direction);
 	declare_name(mask);
 
-	static Vector<Name::Entry>& name_entries()
-	{
-		static Vector<Name::Entry> entries;
-		return entries;
-	}
+	// Table is split into shards by hash. Readers never take locks: they load the current hash table of the shard and probe
+	// it. Writers lock only one shard, publish the entry first and the slot in the hash table after it. Replaced hash tables
+	// are never freed, because readers can still probe them
+	static constexpr size_t name_shards_count           = 64;
+	static constexpr size_t name_shard_initial_capacity = 64;
+	static constexpr size_t name_chunk_size             = 4096;
+	static constexpr size_t name_max_chunks             = 16384;
+
+	struct NameHashTable {
+		size_t mask;
+		Atomic<Index>* slots;// Index of the entry + 1, zero is an empty slot
+		NameHashTable* previous;
+	};
+
+	struct alignas(64) NameShard {
+		Atomic<NameHashTable*> table = nullptr;
+		size_t count                 = 0;
+		CriticalSection section;
+	};
+
+	struct NameTable {
+		NameShard shards[name_shards_count];
+		Atomic<Name::Entry*> chunks[name_max_chunks] = {};
+		Atomic<Index> next_index                     = 0;
+	};
 
-	static MultiMap<HashIndex, Index>& name_index_map()
+	static NameTable& name_table()
 	{
-		static MultiMap<HashIndex, Index> indices;
-		return indices;
+		// Names are used during static deinitialization, so the table is never destroyed
+		static NameTable* table = new NameTable();
+		return *table;
 	}
 
 	static const String& default_string()
@@ -48,40 +71,148 @@ namespace Engine
 		return default_name;
 	}
 
-	static FORCE_INLINE void push_new_name(const char* name, size_t len, HashIndex hash)
+	static FORCE_INLINE NameShard& shard_of(HashIndex hash)
 	{
-		name_index_map().insert({hash, name_entries().size()});
-		name_entries().push_back(Name::Entry{String(name, len), hash});
+		return name_table().shards[hash % name_shards_count];
 	}
 
+	static FORCE_INLINE size_t first_slot_of(HashIndex hash, size_t mask)
+	{
+		return (hash / name_shards_count) & mask;
+	}
 
-	ENGINE_EXPORT Name Name::none;
+	static FORCE_INLINE const Name::Entry& entry_of(Index index)
+	{
+		Name::Entry* chunk = name_table().chunks[index / name_chunk_size].load(std::memory_order_acquire);
+		return chunk[index % name_chunk_size];
+	}
 
-	Name Name::find_name(const StringView& name)
+	static NameHashTable* create_hash_table(size_t capacity, NameHashTable* previous)
 	{
-		Name out_name;
-		HashIndex hash = memory_hash_fast(name.data(), name.length(), 0);
+		NameHashTable* table = new NameHashTable();
+		table->mask          = capacity - 1;
+		table->slots         = new Atomic<Index>[capacity];
+		table->previous      = previous;
+
+		for (size_t i = 0; i < capacity; ++i)
+		{
+			table->slots[i].store(0, std::memory_order_relaxed);
+		}
+		return table;
+	}
+
+	static FORCE_INLINE void insert_slot(NameHashTable* table, HashIndex hash, Index index)
+	{
+		size_t slot = first_slot_of(hash, table->mask);
+
+		while (table->slots[slot].load(std::memory_order_relaxed) != 0)
+		{
+			slot = (slot + 1) & table->mask;
+		}
+
+		table->slots[slot].store(index + 1, std::memory_order_release);
+	}
+
+	static Index find_index(NameShard& shard, const StringView& view, HashIndex hash)
+	{
+		NameHashTable* table = shard.table.load(std::memory_order_acquire);
+
+		if (table == nullptr)
+			return Constants::index_none;
+
+		for (size_t slot = first_slot_of(hash, table->mask);; slot = (slot + 1) & table->mask)
+		{
+			Index value = table->slots[slot].load(std::memory_order_acquire);
+
+			if (value == 0)
+				return Constants::index_none;
+
+			const Name::Entry& entry = entry_of(value - 1);
+
+			if (entry.hash == hash && entry.name == view)
+				return value - 1;
+		}
+	}
+
+	static Name::Entry* entry_storage(Index index)
+	{
+		const size_t chunk_index = index / name_chunk_size;
+
+		if (chunk_index >= name_max_chunks)
+			throw EngineException("Name table overflow");
+
+		Atomic<Name::Entry*>& chunk = name_table().chunks[chunk_index];
+		Name::Entry* storage        = chunk.load(std::memory_order_acquire);
 
-		Vector<Name::Entry>& name_table = name_entries();
+		if (storage == nullptr)
+		{
+			// Several threads can allocate the same chunk, only one of them wins
+			auto* new_storage = static_cast<Name::Entry*>(::operator new(sizeof(Name::Entry) * name_chunk_size));
+
+			if (chunk.compare_exchange_strong(storage, new_storage, std::memory_order_acq_rel))
+				storage = new_storage;
+			else
+				::operator delete(new_storage);
+		}
+
+		return storage + (index % name_chunk_size);
+	}
 
-		out_name.m_index = name_table.size();
+	static Index insert_name(NameShard& shard, const StringView& view, HashIndex hash)
+	{
+		ScopeLock lock(shard.section);
+
+		// Other thread could insert the same name while this thread was waiting for the lock
+		Index index = find_index(shard, view, hash);
+
+		if (index != Constants::index_none)
+			return index;
 
-		for (Index index = 0; index < out_name.m_index; ++index)
+		NameHashTable* table = shard.table.load(std::memory_order_relaxed);
+
+		if (table == nullptr || (shard.count + 1) * 4 > (table->mask + 1) * 3)
 		{
-			const Name::Entry& entry = name_table[index];
+			const size_t capacity = table ? (table->mask + 1) * 2 : name_shard_initial_capacity;
+			NameHashTable* grown  = create_hash_table(capacity, table);
 
-			if (entry.hash == hash)
+			if (table)
 			{
-				out_name.m_index = index;
-				return out_name;
+				for (size_t slot = 0; slot <= table->mask; ++slot)
+				{
+					if (Index value = table->slots[slot].load(std::memory_order_relaxed))
+					{
+						insert_slot(grown, entry_of(value - 1).hash, value - 1);
+					}
+				}
 			}
+
+			shard.table.store(grown, std::memory_order_release);
+			table = grown;
 		}
 
-		out_name.m_index = Constants::index_none;
-		return out_name;
+		index = name_table().next_index.fetch_add(1, std::memory_order_relaxed);
+		new (entry_storage(index)) Name::Entry{String(view), hash};
+		insert_slot(table, hash, index);
+		++shard.count;
+		return index;
 	}
 
 
+	ENGINE_EXPORT Name Name::none;
+
+	Name Name::find_name(const StringView& name)
+	{
+		Name out_name;
+
+		if (!name.empty())
+		{
+			HashIndex hash   = memory_hash_fast(name.data(), name.length(), 0);
+			out_name.m_index = find_index(shard_of(hash), name, hash);
+		}
+
+		return out_name;
+	}
+
 	Name& Name::init(const StringView& view)
 	{
 		if (view.empty())
@@ -90,28 +221,15 @@ namespace Engine
 			return *this;
 		}
 
-		HashIndex hash                      = memory_hash_fast(view.data(), view.length(), 0);
-		Vector<Name::Entry>& name_table     = name_entries();
-		MultiMap<HashIndex, Index>& indices = name_index_map();
-
-		m_index = name_table.size();
+		HashIndex hash   = memory_hash_fast(view.data(), view.length(), 0);
+		NameShard& shard = shard_of(hash);
+		m_index          = find_index(shard, view, hash);
 
-		auto range = indices.equal_range(hash);
-
-		while (range.first != range.second)
+		if (m_index == Constants::index_none)
 		{
-			Index index = range.first->second;
-
-			if (name_table[index].name == view)
-			{
-				m_index = index;
-				return *this;
-			}
-
-			++range.first;
+			m_index = insert_name(shard, view, hash);
 		}
 
-		push_new_name(view.data(), view.length(), hash);
 		return *this;
 	}
 
@@ -160,7 +278,7 @@ namespace Engine
 
 	HashIndex Name::hash() const
 	{
-		return is_valid() ? name_entries()[m_index].hash : Constants::invalid_hash;
+		return is_valid() ? entry_of(m_index).hash : Constants::invalid_hash;
 	}
 
 	Index Name::index() const
@@ -217,7 +335,7 @@ namespace Engine
 	{
 		if (is_valid())
 		{
-			const String& str = name_entries()[m_index].name;
+			const String& str = entry_of(m_index).name;
 			return str == name;
 		}
 
@@ -234,7 +352,7 @@ namespace Engine
 	{
 		if (is_valid())
 		{
-			out += name_entries()[m_index].name;
+			out += entry_of(m_index).name;
 		}
 
 		return *this;
@@ -244,7 +362,7 @@ namespace Engine
 	{
 		if (is_valid())
 		{
-			return name_entries()[m_index].name;
+			return entry_of(m_index).name;
 		}
 
 		return default_string();
@@ -265,13 +383,26 @@ namespace Engine
 		return to_string();
 	}
 
-	const Vector<Name::Entry>& Name::entries()
+	size_t Name::entries_count()
 	{
-		return name_entries();
+		return name_table().next_index.load(std::memory_order_acquire);
 	}
 
 	bool Name::serialize(class Archive& ar)
 	{
+		if (ArchiveTables* tables = ar.tables())
+		{
+			uint32_t index = ar.is_saving() ? tables->name_index(*this) : ArchiveTables::none_index;
+			ar.serialize(index);
+
+			if (ar.is_reading())
+			{
+				(*this) = index == ArchiveTables::none_index ? Name() : tables->name(index);
+			}
+
+			return ar;
+		}
+
 		bool valid = is_valid();
 		ar.serialize(valid);
 
@@ -1,4 +1,6 @@
 #include <Core/archive.hpp>
+#include <Core/asset_loader.hpp>
+#include <Core/asset_registry.hpp>
 #include <Core/base_engine.hpp>
 #include <Core/buffer_manager.hpp>
 #include <Core/compressor.hpp>
@@ -8,12 +10,14 @@
 #include <Core/file_flag.hpp>
 #include <Core/file_manager.hpp>
 #include <Core/filesystem/root_filesystem.hpp>
+#include <Core/garbage_collector.hpp>
 #include <Core/logger.hpp>
 #include <Core/memory.hpp>
 #include <Core/object.hpp>
 #include <Core/package.hpp>
 #include <Core/pointer.hpp>
 #include <Core/reflection/class.hpp>
+#include <Core/reflection/property.hpp>
 #include <Core/render_resource.hpp>
 #include <Core/string_functions.hpp>
 #include <Core/threading.hpp>
@@ -81,16 +85,22 @@ namespace Engine
 		}
 	}
 
-	static Vector<Index>& get_free_indexes_array()
-	{
-		static Vector<Index> array;
-		return array;
-	}
+	struct ObjectRegistry {
+		struct Slot {
+			Object* object      = nullptr;
+			uint32_t generation = 0;
+		};
+
+		Vector<Object*> objects;
+		Vector<Slot> slots;
+		Vector<uint32_t> free_slots;
+	};
 
-	static Vector<Object*>& get_instances_array()
+	static ObjectRegistry& object_registry()
 	{
-		static Vector<Object*> array;
-		return array;
+		// Registry is never destroyed, because objects can be destroyed during static deinitialization
+		static ObjectRegistry* registry = new ObjectRegistry();
+		return *registry;
 	}
 
 	static Package* m_root_package = nullptr;
@@ -163,7 +173,7 @@ namespace Engine
 		return 0;
 	}
 
-	Object::Object() : m_references(0), m_instance_index(Constants::index_none)
+	Object::Object() : m_references(0), m_instance_index(Constants::index_none), m_class_instance_index(Constants::index_none)
 	{
 		trinex_always_check(is_in_logic_thread(), "Cannot create new object instance outside logic thread!");
 		if (next_object_info.class_instance == nullptr)
@@ -179,20 +189,10 @@ namespace Engine
 		m_class = next_object_info.class_instance;
 		next_object_info.reset();
 
+		++m_class->m_allocations_count;
 
-		Vector<Object*>& objects_array = get_instances_array();
-
-		if (!get_free_indexes_array().empty())
-		{
-			m_instance_index = get_free_indexes_array().back();
-			get_free_indexes_array().pop_back();
-			objects_array[m_instance_index] = this;
-		}
-		else
-		{
-			m_instance_index = objects_array.size();
-			objects_array.push_back(this);
-		}
+		add_to_instances_array();
+		GarbageCollector::on_object_created(this);
 	}
 
 	class Refl::Class* Object::class_instance() const
@@ -243,23 +243,77 @@ namespace Engine
 	}
 
 
-	const Object& Object::remove_from_instances_array() const
+	template<typename ObjectType>
+	static FORCE_INLINE void swap_and_pop(Vector<ObjectType*>& objects, Index index, Index ObjectType::*member)
+	{
+		ObjectType* last = objects.back();
+		objects[index]   = last;
+		last->*member    = index;
+		objects.pop_back();
+	}
+
+	const Object& Object::add_to_instances_array()
 	{
-		if (engine_instance && m_instance_index < get_instances_array().size())
+		ObjectRegistry& registry = object_registry();
+
+		if (registry.free_slots.empty())
 		{
-			get_instances_array()[m_instance_index] = nullptr;
-			if (!engine_instance->is_shuting_down())
-			{
-				get_free_indexes_array().push_back(m_instance_index);
-			}
-			m_instance_index = Constants::max_size;
+			m_handle.index = static_cast<uint32_t>(registry.slots.size());
+			registry.slots.emplace_back();
 		}
+		else
+		{
+			m_handle.index = registry.free_slots.back();
+			registry.free_slots.pop_back();
+		}
+
+		auto& slot          = registry.slots[m_handle.index];
+		slot.object         = this;
+		m_handle.generation = slot.generation;
+
+		m_instance_index = registry.objects.size();
+		registry.objects.push_back(this);
+
+		m_class_instance_index = m_class->m_instances.size();
+		m_class->m_instances.push_back(this);
+		return *this;
+	}
+
+	const Object& Object::remove_from_instances_array() const
+	{
+		ObjectRegistry& registry = object_registry();
+
+		if (m_instance_index >= registry.objects.size())
+			return *this;
+
+		auto& slot = registry.slots[m_handle.index];
+		slot.object = nullptr;
+		++slot.generation;
+		registry.free_slots.push_back(m_handle.index);
+
+		swap_and_pop(registry.objects, m_instance_index, &Object::m_instance_index);
+		swap_and_pop(m_class->m_instances, m_class_instance_index, &Object::m_class_instance_index);
+
+		m_instance_index       = Constants::index_none;
+		m_class_instance_index = Constants::index_none;
+		m_handle               = {};
 		return *this;
 	}
 
 	ENGINE_EXPORT const Vector<Object*>& Object::all_objects()
 	{
-		return get_instances_array();
+		return object_registry().objects;
+	}
+
+	Object* Object::object_of(const ObjectHandle& handle)
+	{
+		const ObjectRegistry& registry = object_registry();
+
+		if (handle.index >= registry.slots.size())
+			return nullptr;
+
+		const auto& slot = registry.slots[handle.index];
+		return slot.generation == handle.generation ? slot.object : nullptr;
 	}
 
 	Object::~Object()
@@ -512,6 +566,7 @@ namespace Engine
 			if ((result = new_owner->register_child(this)))
 			{
 				m_owner = new_owner;
+				GarbageCollector::write_barrier(this);
 			}
 			else
 			{
@@ -557,6 +612,11 @@ namespace Engine
 		return m_instance_index;
 	}
 
+	const ObjectHandle& Object::handle() const
+	{
+		return m_handle;
+	}
+
 	bool Object::serialize(Archive& archive)
 	{
 		if (!flags(Flag::IsSerializable))
@@ -604,85 +664,123 @@ namespace Engine
 		return flags(IsDirty);
 	}
 
-	template<typename Type>
-	static Type* open_asset_file(const Object* object, bool create_dir = false)
-	{
-		Path path = Path(Project::assets_dir) / object->filepath();
+	static constexpr size_t asset_tables_marker = 0x53454C4241544E54;// TNTABLES
 
-		if (create_dir)
+	bool Object::save_snapshot(Buffer& raw_data, Vector<String>& dependencies, Flags<SerializationFlags> serialization_flags)
+	{
+		if (!flags(Object::IsSerializable))
 		{
-			rootfs()->create_dir(path.base_path());
+			error_log("Object", "Cannot save non-serializable package!");
+			return false;
 		}
 
-		Type* value = new Type(path);
-		if (value->is_open())
-		{
-			return value;
-		}
+		ArchiveTables tables;
+		Vector<byte> body_buffer;
+		VectorWriter body_writer = &body_buffer;
+		Archive body_ar          = &body_writer;
+		body_ar.flags            = serialization_flags;
+		body_ar.tables(&tables);
 
-		delete value;
+		auto hierarchy = class_instance()->hierarchy(1);
+		body_ar.serialize(hierarchy);
 
-		if constexpr (std::is_base_of_v<BufferReader, Type>)
-		{
-			error_log("Object", "Failed to load object '%s': File '%s' not found!", object->full_name().c_str(), path.c_str());
-		}
-		else
+		if (!serialize(body_ar))
 		{
-			error_log("Object", "Failed to save object'%s': Failed to create file '%s'!", object->full_name().c_str(),
-					  path.c_str());
+			return false;
 		}
 
-		return nullptr;
+		// Tables are known only when the object is serialized, so they are written before the body afterwards
+		raw_data.clear();
+		VectorWriter raw_writer = &raw_data;
+		Archive raw_ar          = &raw_writer;
+		size_t marker           = asset_tables_marker;
+
+		raw_ar.serialize(marker);
+		tables.serialize(raw_ar);
+		raw_ar.write_data(body_buffer.data(), body_buffer.size());
+
+		dependencies = tables.imports();
+		return raw_ar;
 	}
 
-	bool Object::save(class BufferWriter* writer, Flags<SerializationFlags> serialization_flags)
+	static bool write_asset_data(BufferWriter* writer, const Buffer& raw_data, const AssetRegistry::Header& header)
 	{
-		if (!flags(Object::IsSerializable))
-		{
-			error_log("Object", "Cannot save non-serializable package!");
-			return false;
-		}
+		Vector<byte> compressed_buffer;
+		Compressor::compress(raw_data, compressed_buffer);
 
-		bool status;
-		Vector<byte> raw_buffer;
-		VectorWriter raw_writer = &raw_buffer;
-		Archive raw_ar          = &raw_writer;
-		raw_ar.flags            = serialization_flags;
+		// References are stored in the uncompressed header, so the registry can read them without loading the object
+		Archive ar(writer);
+		AssetRegistry::write_header(ar, header);
+		ar.serialize(compressed_buffer);
+		return ar;
+	}
 
-		auto hierarchy = class_instance()->hierarchy(1);
-		raw_ar.serialize(hierarchy);
+	bool Object::write_snapshot(BufferWriter* writer, const Buffer& raw_data, const Vector<String>& dependencies)
+	{
+		AssetRegistry::Header header;
+		header.dependencies = dependencies;
+		header.content_hash = memory_hash_fast(raw_data.data(), raw_data.size());
+		return write_asset_data(writer, raw_data, header);
+	}
+
+	bool Object::write_snapshot(StringView fullname, const Buffer& raw_data, const Vector<String>& dependencies)
+	{
+		AssetRegistry::Header header;
+		header.dependencies = dependencies;
+		header.content_hash = memory_hash_fast(raw_data.data(), raw_data.size());
 
-		status = serialize(raw_ar);
+		Path path = asset_path_of(fullname);
 
-		if (!status)
+		if (!AssetRegistry::is_saved(fullname, header.content_hash))
 		{
-			return false;
-		}
+			rootfs()->create_dir(path.base_path());
 
-		Vector<byte> compressed_buffer;
-		Compressor::compress(raw_buffer, compressed_buffer);
+			// Asset is written into the temporary file first, so the interrupted save never leaves the broken asset
+			Path temp_path = path + ".tmp";
+			bool status;
 
-		bool need_destroy_writer = (writer == nullptr);
+			{
+				FileWriter writer(temp_path);
 
-		if (need_destroy_writer)
-		{
-			writer = open_asset_file<FileWriter>(this, true);
+				if (!writer.is_open())
+				{
+					error_log("Object", "Failed to save object'%s': Failed to create file '%s'!", String(fullname).c_str(),
+					          temp_path.c_str());
+					return false;
+				}
+
+				status = write_asset_data(&writer, raw_data, header);
+			}
+
+			if (!status || !rootfs()->rename(temp_path, path))
+			{
+				rootfs()->remove(temp_path);
+				error_log("Object", "Failed to save object'%s': Failed to write file '%s'!", String(fullname).c_str(),
+				          path.c_str());
+				return false;
+			}
 		}
 
-		if (!writer)
+		AssetRegistry::update(fullname, header);
+		return true;
+	}
+
+	bool Object::save(class BufferWriter* writer, Flags<SerializationFlags> serialization_flags)
+	{
+		Buffer raw_data;
+		Vector<String> dependencies;
+
+		if (!save_snapshot(raw_data, dependencies, serialization_flags))
 			return false;
 
-		Archive ar(writer);
-		FileFlag flag = FileFlag::asset_flag();
-		ar.serialize(flag);
-		ar.serialize(compressed_buffer);
+		if (writer)
+			return write_snapshot(writer, raw_data, dependencies);
 
-		if (need_destroy_writer)
-		{
-			delete writer;
-		}
+		if (!write_snapshot(full_name(), raw_data, dependencies))
+			return false;
 
-		return ar;
+		flags(IsDirty, false);
+		return true;
 	}
 
 	static FORCE_INLINE Refl::Class* find_class(const Vector<Name>& hierarchy)
@@ -700,43 +798,84 @@ namespace Engine
 		return instance;
 	}
 
-	ENGINE_EXPORT Object* Object::load_object(StringView fullname, class BufferReader* reader,
-											  Flags<SerializationFlags> serialization_flags)
+	Path Object::asset_path_of(StringView fullname)
 	{
-		if (reader == nullptr)
+		return Path(Project::assets_dir) /
+		       Path(Strings::replace_all(fullname, Constants::name_separator, Path::sv_separator) + Constants::asset_extention);
+	}
+
+	static bool read_compressed_asset_data(BufferReader* reader, Span<const byte>& compressed_buffer, Buffer& compressed_storage,
+	                                       AssetRegistry::Header* header = nullptr)
+	{
+		Archive ar(reader);
+
+		if (!AssetRegistry::read_header(ar, header))
 		{
-			error_log("Object", "Cannot load object from nullptr buffer reader!");
-			return nullptr;
+			error_log("Object", "Cannot load object. Asset flag mismatch!");
+			return false;
 		}
 
-		if (!serialization_flags(SerializationFlags::SkipObjectSearch))
+		// Memory based readers give direct access to the compressed data, so it is decompressed without copying
+		if (!ar.read_buffer_view(compressed_buffer, compressed_storage))
 		{
-			if (Object* object = static_find_object(fullname))
-			{
-				return object;
-			}
+			error_log("Object", "Failed to read compressed buffer!");
+			return false;
 		}
 
-		Archive ar(reader);
-		FileFlag flag = FileFlag::asset_flag();
-		ar.serialize(flag);
-		if (flag != FileFlag::asset_flag())
+		return true;
+	}
+
+	bool Object::read_asset_data(class BufferReader* reader, Buffer& raw_data, Vector<String>* dependencies)
+	{
+		Buffer compressed_storage;
+		Span<const byte> compressed_buffer;
+		AssetRegistry::Header header;
+
+		if (!read_compressed_asset_data(reader, compressed_buffer, compressed_storage, dependencies ? &header : nullptr))
+			return false;
+
+		if (dependencies)
+			(*dependencies) = std::move(header.dependencies);
+
+		Compressor::decompress(compressed_buffer.data(), compressed_buffer.size(), raw_data);
+		return true;
+	}
+
+	Object* Object::load_object_from_data(StringView fullname, const Buffer& raw_data)
+	{
+		VectorReader raw_reader = &raw_data;
+		return load_object_from_data(fullname, &raw_reader);
+	}
+
+	Object* Object::load_object_from_data(StringView fullname, BufferReader* raw_reader)
+	{
+		Archive raw_ar = raw_reader;
+
+		if (!raw_ar)
 		{
-			error_log("Object", "Cannot load object. Asset flag mismatch!");
+			error_log("Object", "Cannot load object. Failed to decompress asset data!");
 			return nullptr;
 		}
 
-		Vector<byte> compressed_buffer;
-		if (!(ar.serialize(compressed_buffer)))
+		// Assets saved without tables start with the class hierarchy
+		ArchiveTables tables;
+		size_t marker = 0;
+		raw_ar.serialize(marker);
+
+		if (marker == asset_tables_marker)
 		{
-			error_log("Object", "Failed to read compressed buffer!");
-			return nullptr;
-		}
+			if (!tables.serialize(raw_ar))
+			{
+				error_log("Object", "Cannot load object. Failed to read asset tables!");
+				return nullptr;
+			}
 
-		Vector<byte> raw_data;
-		Compressor::decompress(compressed_buffer, raw_data);
-		VectorReader raw_reader = &raw_data;
-		Archive raw_ar          = &raw_reader;
+			raw_ar.tables(&tables);
+		}
+		else
+		{
+			raw_ar.position(0);
+		}
 
 		Vector<Name> hierarchy;
 		raw_ar.serialize(hierarchy);
@@ -745,7 +884,7 @@ namespace Engine
 
 		if (self == nullptr)
 		{
-			error_log("Object", "Cannot load object. Class '%s' not found!", hierarchy.front().c_str());
+			error_log("Object", "Cannot load object. Class '%s' not found!", hierarchy.empty() ? "" : hierarchy.front().c_str());
 			return nullptr;
 		}
 
@@ -759,10 +898,19 @@ namespace Engine
 			object->rename(object_name, Package::static_find_package(package_name, true));
 		}
 
+		// Asynchronous loader cancels the object if some of its references are not loaded yet. It happens only for the assets
+		// saved without the list of references, other assets are created when all their references are read
+		const size_t missing_dependencies = AssetLoader::missing_dependencies_count();
+
 		object->preload();
 		bool valid = object->serialize(raw_ar);
 
-		if (!valid)
+		if (AssetLoader::missing_dependencies_count() != missing_dependencies)
+		{
+			delete object;
+			object = nullptr;
+		}
+		else if (!valid)
 		{
 			error_log("Object", "Failed to load object");
 			delete object;
@@ -775,6 +923,34 @@ namespace Engine
 		return object;
 	}
 
+	ENGINE_EXPORT Object* Object::load_object(StringView fullname, class BufferReader* reader,
+											  Flags<SerializationFlags> serialization_flags)
+	{
+		if (reader == nullptr)
+		{
+			error_log("Object", "Cannot load object from nullptr buffer reader!");
+			return nullptr;
+		}
+
+		if (!serialization_flags(SerializationFlags::SkipObjectSearch))
+		{
+			if (Object* object = static_find_object(fullname))
+			{
+				return object;
+			}
+		}
+
+		Buffer compressed_storage;
+		Span<const byte> compressed_buffer;
+
+		if (!read_compressed_asset_data(reader, compressed_buffer, compressed_storage))
+			return nullptr;
+
+		// Blocks are decompressed while the object is deserialized
+		Compressor::StreamReader raw_reader(compressed_buffer);
+		return load_object_from_data(fullname, &raw_reader);
+	}
+
 	static Object* load_from_file_internal(const Path& path, StringView fullname, Flags<SerializationFlags> flags)
 	{
 		FileReader reader(path);
@@ -795,9 +971,7 @@ namespace Engine
 				return object;
 		}
 
-		Path path = Path(Project::assets_dir) /
-					Path(Strings::replace_all(name, Constants::name_separator, Path::sv_separator) + Constants::asset_extention);
-		return load_from_file_internal(path, name, flags | SerializationFlags::SkipObjectSearch);
+		return load_from_file_internal(asset_path_of(name), name, flags | SerializationFlags::SkipObjectSearch);
 	}
 
 	ENGINE_EXPORT Object* Object::load_object_from_file(const Path& path, Flags<SerializationFlags> flags)
@@ -815,6 +989,11 @@ namespace Engine
 		return load_from_file_internal(Path(Project::assets_dir) / path, full_name, flags | SerializationFlags::SkipObjectSearch);
 	}
 
+	ENGINE_EXPORT LoadHandle Object::load_object_async(StringView fullname, LoadPriority priority)
+	{
+		return AssetLoader::load(fullname, priority);
+	}
+
 	bool Object::is_serializable() const
 	{
 		return flags(IsSerializable);
@@ -849,32 +1028,118 @@ namespace Engine
 		return true;
 	}
 
+	using CopyRemapping = Map<Object*, Object*>;
+
+	static void map_composite_objects(Refl::Struct* self, void* src, void* dst, CopyRemapping& remapping);
+
+	static void map_composite_object(Refl::Property* prop, void* src, void* dst, CopyRemapping& remapping)
+	{
+		if (auto object_prop = Refl::Object::instance_cast<Refl::ObjectProperty>(prop))
+		{
+			if (!object_prop->is_composite())
+				return;
+
+			Object* src_object = object_prop->object(src);
+			Object* dst_object = object_prop->object(dst);
+
+			if (src_object && dst_object && remapping.try_emplace(src_object, dst_object).second)
+			{
+				map_composite_objects(src_object->class_instance(), src_object, dst_object, remapping);
+			}
+		}
+		else if (auto struct_prop = Refl::Object::instance_cast<Refl::StructProperty>(prop))
+		{
+			map_composite_objects(struct_prop->struct_instance(), struct_prop->address(src), struct_prop->address(dst), remapping);
+		}
+		else if (auto array_prop = Refl::Object::instance_cast<Refl::ArrayProperty>(prop))
+		{
+			Refl::Property* element = array_prop->element_property();
+			const size_t length     = glm::min(array_prop->length(src), array_prop->length(dst));
+
+			for (size_t index = 0; index < length; ++index)
+			{
+				map_composite_object(element, array_prop->at(src, index), array_prop->at(dst, index), remapping);
+			}
+		}
+	}
+
+	// Composite subobjects are created by the constructor of the copy, so they are matched by the properties which hold them
+	static void map_composite_objects(Refl::Struct* self, void* src, void* dst, CopyRemapping& remapping)
+	{
+		for (; self; self = self->parent())
+		{
+			for (Refl::Property* prop : self->properties())
+			{
+				map_composite_object(prop, src, dst, remapping);
+			}
+		}
+	}
+
 	ENGINE_EXPORT Object* Object::copy_from(Object* src)
 	{
-		Flags<SerializationFlags> flags = SerializationFlags::IsCopyProcess;
+		Vector<Object*> copies = clone_n(src, 1);
+		return copies.empty() ? nullptr : copies.front();
+	}
+
+	ENGINE_EXPORT Vector<Object*> Object::clone_n(Object* src, size_t count)
+	{
+		Vector<Object*> copies;
+
+		if (src == nullptr || count == 0)
+			return copies;
 
+		// Source is serialized once, each copy is read from the same buffer
 		Buffer buffer;
+		ArchiveTables tables(true);
 		{
-			VectorWriter writer(&buffer);
+			VectorWriter writer = &buffer;
+			Archive ar          = &writer;
+			ar.flags            = SerializationFlags::IsCopyProcess;
+			ar.tables(&tables);
 
-			if (!src->save(&writer, flags))
+			if (!src->serialize(ar))
 			{
 				error_log("Object", "Failed to save object to buffer!");
-				return nullptr;
+				return copies;
 			}
 		}
 
+		// Imports are replaced by the objects of each copy, so the source references are kept aside
+		const Vector<Object*> imports = tables.resolved_imports();
+		copies.reserve(count);
+
+		for (size_t index = 0; index < count; ++index)
 		{
-			VectorReader reader(&buffer);
-			Object* new_object = Object::load_object("", &reader, flags);
+			Object* copy = src->class_instance()->create_object();
+
+			CopyRemapping remapping = {{src, copy}};
+			map_composite_objects(src->class_instance(), src, copy, remapping);
 
-			if (!new_object)
+			for (uint32_t import = 0; import < imports.size(); ++import)
+			{
+				auto it = remapping.find(imports[import]);
+				tables.import_object(import, it != remapping.end() ? it->second : imports[import]);
+			}
+
+			VectorReader reader = &buffer;
+			Archive ar          = &reader;
+			ar.flags            = SerializationFlags::IsCopyProcess;
+			ar.tables(&tables);
+
+			copy->preload();
+
+			if (!copy->serialize(ar))
 			{
 				error_log("Object", "Failed to create copy of object!");
+				delete copy;
+				break;
 			}
 
-			return new_object;
+			copy->postload();
+			copies.push_back(copy);
 		}
+
+		return copies;
 	}
 
 	Object* Object::static_new_instance(Refl::Class* object_class, StringView name, Object* owner)
@@ -1,6 +1,10 @@
+#include <Core/asset_registry.hpp>
 #include <Core/engine_loading_controllers.hpp>
+#include <Core/etl/critical_section.hpp>
+#include <Core/etl/set.hpp>
 #include <Core/logger.hpp>
 #include <Core/package.hpp>
+#include <Core/parallel.hpp>
 #include <Core/reflection/class.hpp>
 #include <Core/string_functions.hpp>
 
@@ -82,34 +86,189 @@ namespace Engine
 		return find_child_object(Strings::parse_name_identifier(name)) != nullptr;
 	}
 
-	bool Package::save(BufferWriter* writer, Flags<SerializationFlags> serialization_flags)
+	struct PackageSaveEntry {
+		String name;
+		Buffer raw_data;
+		Vector<String> dependencies;
+	};
+
+	struct PackageSaveState {
+		CriticalSection section;
+		TreeSet<String, std::less<>> failed_objects;// Objects which must be written again, even if they are not dirty
+		JobHandle last_job;
+	};
+
+	static PackageSaveState& package_save_state()
 	{
-		if (!flags(Object::IsSerializable))
+		static PackageSaveState* state = new PackageSaveState();
+		return *state;
+	}
+
+	static bool is_save_required(Object* object, const String& fullname)
+	{
+		// Registry knows each asset file which was found by the scan or written by the engine, so the file system is not
+		// accessed for each object
+		if (object->is_dirty() || !AssetRegistry::contains(fullname))
+			return true;
+
+		PackageSaveState& state = package_save_state();
+		ScopeLock lock(state.section);
+		return state.failed_objects.contains(fullname);
+	}
+
+	static bool collect_modified_object(Object* object, Vector<PackageSaveEntry>& entries, Flags<SerializationFlags> flags)
+	{
+		String fullname = object->full_name();
+
+		if (!is_save_required(object, fullname))
+			return true;
+
+		PackageSaveEntry& entry = entries.emplace_back();
+		entry.name              = std::move(fullname);
+
+		if (!object->save_snapshot(entry.raw_data, entry.dependencies, flags))
 		{
-			error_log("Package", "Cannot save non-serializable package!");
+			entries.pop_back();
 			return false;
 		}
 
+		// Changes made after the snapshot will mark object dirty again
+		object->flags(Object::IsDirty, false);
+		return true;
+	}
+
+	static bool collect_modified_objects(Package* package, Vector<PackageSaveEntry>& entries, Flags<SerializationFlags> flags)
+	{
 		bool result = true;
 
-		for (Object* object : m_child_objects)
+		for (Object* object : package->objects())
 		{
 			if (Package* sub_package = object->instance_cast<Package>())
 			{
-				result = sub_package->save(writer, serialization_flags);
+				if (sub_package->is_serializable())
+					result = collect_modified_objects(sub_package, entries, flags) && result;
 				continue;
 			}
 
-			object->save(writer, serialization_flags);
+			if (!object->is_serializable())
+				continue;
+
+			result = collect_modified_object(object, entries, flags) && result;
+		}
+
+		return result;
+	}
+
+	static bool write_modified_objects(Vector<PackageSaveEntry>& entries)
+	{
+		PackageSaveState& state = package_save_state();
+		Atomic<bool> result     = true;
+
+		parallel_for(entries.size(), 1, [&](size_t index) {
+			PackageSaveEntry& entry = entries[index];
+			const bool status       = Object::write_snapshot(entry.name, entry.raw_data, entry.dependencies);
 
-			if (result == false)
+			ScopeLock lock(state.section);
+
+			if (status)
 			{
-				return result;
+				state.failed_objects.erase(entry.name);
 			}
-		}
+			else
+			{
+				state.failed_objects.insert(entry.name);
+				result = false;
+			}
+		});
+
 		return result;
 	}
 
+	static JobHandle write_modified_objects_async(Vector<PackageSaveEntry>&& entries)
+	{
+		if (entries.empty())
+			return {};
+
+		// Saves are chained, so the older snapshot never overwrites the newer one
+		PackageSaveState& state = package_save_state();
+		state.last_job = ThreadManager::instance()->call_function_after({state.last_job}, [entries = std::move(entries)]() mutable {
+			write_modified_objects(entries);
+		});
+		return state.last_job;
+	}
+
+	bool Package::save(BufferWriter* writer, Flags<SerializationFlags> serialization_flags)
+	{
+		if (!flags(Object::IsSerializable))
+		{
+			error_log("Package", "Cannot save non-serializable package!");
+			return false;
+		}
+
+		if (writer)
+		{
+			bool result = true;
+
+			for (Object* object : m_child_objects)
+			{
+				if (Package* sub_package = object->instance_cast<Package>())
+				{
+					result = sub_package->save(writer, serialization_flags);
+					continue;
+				}
+
+				object->save(writer, serialization_flags);
+
+				if (result == false)
+				{
+					return result;
+				}
+			}
+			return result;
+		}
+
+		Vector<PackageSaveEntry> entries;
+		bool result = collect_modified_objects(this, entries, serialization_flags);
+
+		// Background save can still write the same files
+		wait_for_async_saves();
+		return write_modified_objects(entries) && result;
+	}
+
+	JobHandle Package::save_async(Flags<SerializationFlags> serialization_flags)
+	{
+		if (!flags(Object::IsSerializable))
+		{
+			error_log("Package", "Cannot save non-serializable package!");
+			return {};
+		}
+
+		Vector<PackageSaveEntry> entries;
+		collect_modified_objects(this, entries, serialization_flags);
+		return write_modified_objects_async(std::move(entries));
+	}
+
+	JobHandle Package::save_object_async(Object* object, Flags<SerializationFlags> serialization_flags)
+	{
+		if (Package* package = object->instance_cast<Package>())
+			return package->save_async(serialization_flags);
+
+		if (!object->is_serializable())
+		{
+			error_log("Package", "Cannot save non-serializable object!");
+			return {};
+		}
+
+		Vector<PackageSaveEntry> entries;
+		collect_modified_object(object, entries, serialization_flags);
+		return write_modified_objects_async(std::move(entries));
+	}
+
+	void Package::wait_for_async_saves()
+	{
+		ThreadManager::instance()->wait(package_save_state().last_job);
+	}
+
 	implement_engine_class(Package, Refl::Class::IsScriptable)
 	{}
 }// namespace Engine
@@ -1,6 +1,7 @@
 #include <Core/archive.hpp>
 #include <Core/base_engine.hpp>
 #include <Core/exception.hpp>
+#include <Core/garbage_collector.hpp>
 #include <Core/object.hpp>
 #include <Core/pointer.hpp>
 
@@ -19,6 +20,7 @@ namespace Engine
 		if (object && can_update_reference())
 		{
 			++object->m_references;
+			GarbageCollector::write_barrier(object);
 		}
 		return *this;
 	}
@@ -177,6 +177,21 @@ namespace Engine::Refl
 		return m_singletone_object;
 	}
 
+	size_t Class::allocations_count() const
+	{
+		return m_allocations_count.load(std::memory_order_relaxed);
+	}
+
+	size_t Class::instances_count() const
+	{
+		return m_instances.size();
+	}
+
+	const Vector<Engine::Object*>& Class::instances() const
+	{
+		return m_instances;
+	}
+
 	const Vector<Class*>& Class::asset_classes()
 	{
 		return get_asset_class_table();
@@ -186,6 +201,8 @@ namespace Engine::Refl
 	{
 		Super::register_layout(r, info, downcast);
 		r.method("Engine::Object@ singletone_instance() const", &Class::singletone_instance);
+		r.method("uint64 allocations_count() const", &Class::allocations_count);
+		r.method("uint64 instances_count() const", &Class::instances_count);
 	}
 
 	static void on_init()
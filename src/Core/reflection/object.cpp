@@ -1,5 +1,6 @@
 #include <Core/constants.hpp>
 #include <Core/engine_loading_controllers.hpp>
+#include <Core/etl/pool_allocator.hpp>
 #include <Core/etl/set.hpp>
 #include <Core/etl/templates.hpp>
 #include <Core/exception.hpp>
@@ -118,6 +119,16 @@ namespace Engine::Refl
 		m_has_next_object_info = false;
 	}
 
+	void* Object::operator new(size_t size)
+	{
+		return PoolAllocator::allocate(size);
+	}
+
+	void Object::operator delete(void* memory, size_t size) noexcept
+	{
+		PoolAllocator::deallocate(memory, size);
+	}
+
 	Object::Object() : m_owner(nullptr), m_name(m_next_object_name)
 	{
 		trinex_always_check(m_has_next_object_info, "Use new_instance or new_child method for creating reflection objects!");
@@ -2,6 +2,7 @@
 #include <Core/engine_loading_controllers.hpp>
 #include <Core/etl/templates.hpp>
 #include <Core/filesystem/path.hpp>
+#include <Core/garbage_collector.hpp>
 #include <Core/logger.hpp>
 #include <Core/reflection/class.hpp>
 #include <Core/reflection/enum.hpp>
@@ -206,6 +207,7 @@ namespace Engine::Refl
 		if (object == nullptr || object->class_instance()->is_a(class_instance()))
 		{
 			(*address_as<Engine::Object*>(context)) = object;
+			GarbageCollector::write_barrier(object);
 			return true;
 		}
 		return false;
@@ -2,6 +2,8 @@
 #include <Core/engine_loading_controllers.hpp>
 #include <Core/exception.hpp>
 #include <Core/group.hpp>
+#include <Core/memory.hpp>
+#include <Core/reflection/class.hpp>
 #include <Core/reflection/property.hpp>
 #include <Core/reflection/struct.hpp>
 #include <ScriptEngine/registrar.hpp>
@@ -54,6 +56,8 @@ namespace Engine::Refl
 
 			if (it != m_properties.end())
 				m_properties.erase(it);
+
+			m_is_serialization_plan_valid = false;
 		}
 
 		return *this;
@@ -66,6 +70,7 @@ namespace Engine::Refl
 		if (auto prop = instance_cast<Property>(subobject))
 		{
 			m_properties.push_back(prop);
+			m_is_serialization_plan_valid = false;
 		}
 
 		return *this;
@@ -191,77 +196,248 @@ namespace Engine::Refl
 		return nullptr;
 	}
 
-	static Vector<Property*> collect_serializable_properties(Refl::Struct* self)
+	// New layout is marked by the highest bit, the previous one starts with the count of properties
+	static constexpr uint64_t layout_hash_bit = static_cast<uint64_t>(1) << 63;
+
+	static uint64_t hash_layout_of(const Property* prop, uint64_t hash)
 	{
-		Vector<Property*> result;
-		result.reserve(20);
+		const String& name = prop->name().to_string();
+		const String& type = prop->refl_class_info()->class_name.to_string();
+		const size_t size  = prop->size();
 
-		for (auto& prop : self->properties())
+		hash = memory_hash_fast(name.data(), name.size(), hash);
+		hash = memory_hash_fast(type.data(), type.size(), hash);
+		hash = memory_hash_fast(&size, sizeof(size), hash);
+
+		if (auto array = Object::instance_cast<const ArrayProperty>(prop))
+		{
+			hash = hash_layout_of(array->element_property(), hash);
+		}
+		else if (auto structure = Object::instance_cast<const StructProperty>(prop))
+		{
+			const String struct_name = structure->struct_instance()->full_name();
+			hash                     = memory_hash_fast(struct_name.data(), struct_name.size(), hash);
+		}
+		else if (auto object = Object::instance_cast<const ObjectProperty>(prop))
+		{
+			const String class_name = object->class_instance()->full_name();
+			hash                    = memory_hash_fast(class_name.data(), class_name.size(), hash);
+		}
+
+		return hash;
+	}
+
+	const Struct::SerializationPlan& Struct::serialization_plan(void* object)
+	{
+		if (m_is_serialization_plan_valid.load(std::memory_order_acquire))
+			return m_serialization_plan;
+
+		ScopeLock lock(m_serialization_plan_section);
+
+		if (m_is_serialization_plan_valid.load(std::memory_order_relaxed))
+			return m_serialization_plan;
+
+		SerializationPlan& plan = m_serialization_plan;
+		plan.properties.clear();
+		plan.steps.clear();
+		plan.layout_hash = 0;
+
+		for (Property* prop : m_properties)
 		{
 			if (prop->is_serializable())
 			{
-				result.push_back(prop);
+				plan.properties.push_back(prop);
+				plan.layout_hash = hash_layout_of(prop, plan.layout_hash);
 			}
 		}
-		return result;
-	}
 
+		plan.layout_hash |= layout_hash_bit;
 
-	bool Struct::serialize_properties(void* object, Archive& ar)
+		const byte* run_end = nullptr;
+
+		for (uint32_t index = 0; index < plan.properties.size(); ++index)
+		{
+			Property* prop = plan.properties[index];
+
+			if (!instance_cast<PrimitiveProperty>(prop))
+			{
+				plan.steps.push_back({prop, 0, index, 1});
+				run_end = nullptr;
+				continue;
+			}
+
+			const byte* address = reinterpret_cast<const byte*>(prop->address(object));
+
+			if (run_end == address)
+			{
+				SerializationStep& step = plan.steps.back();
+				step.size += prop->size();
+				++step.count;
+			}
+			else
+			{
+				plan.steps.push_back({prop, prop->size(), index, 1});
+			}
+
+			run_end = address + prop->size();
+		}
+
+		m_is_serialization_plan_valid.store(true, std::memory_order_release);
+		return plan;
+	}
+
+	bool Struct::save_properties(void* object, Archive& ar)
 	{
-		if (ar.is_saving())
+		const SerializationPlan& plan = serialization_plan(object);
+
+		uint64_t layout_hash = plan.layout_hash;
+		size_t count         = plan.properties.size();
+		ar.serialize(layout_hash, count);
+
+		size_t data_offset = 0;
+		size_t end_offset  = 0;
+
+		const size_t header_pos = ar.position();
+		ar.serialize(data_offset, end_offset);
+
+		// Offsets are used only by the tolerant loading path, when the layout of the struct is changed
+		const size_t start_pos = ar.position();
+		Vector<size_t> offsets(count, 0);
+		ar.write_data(reinterpret_cast<const byte*>(offsets.data()), offsets.size() * sizeof(size_t));
+
+		for (Property* prop : plan.properties)
 		{
-			auto properties = collect_serializable_properties(this);
+			Name name = prop->name();
+			ar.serialize(name);
+		}
 
-			size_t count = properties.size();
-			ar.serialize(count);
+		data_offset = ar.position() - start_pos;
 
-			Vector<size_t> offsets(count + 1, 0);
-			auto start_pos = ar.position();
-			ar.write_data(reinterpret_cast<const byte*>(offsets.data()), offsets.size() * sizeof(size_t));
+		for (const SerializationStep& step : plan.steps)
+		{
+			size_t offset = ar.position() - start_pos;
 
-			count = 0;
-			for (auto& prop : properties)
+			if (step.size == 0)
 			{
-				Name name      = prop->name();
-				offsets[count] = ar.position() - start_pos;
-				ar.serialize(name);
-				prop->serialize(object, ar);
-				++count;
+				offsets[step.first] = offset;
+				step.property->serialize(object, ar);
+				continue;
 			}
 
-			auto end_pos   = ar.position();
-			offsets[count] = end_pos - start_pos;
+			for (uint32_t index = step.first; index < step.first + step.count; ++index)
+			{
+				offsets[index] = offset;
+				offset += plan.properties[index]->size();
+			}
 
-			ar.position(start_pos);
-			ar.write_data(reinterpret_cast<const byte*>(offsets.data()), offsets.size() * sizeof(size_t));
-			ar.position(end_pos);
+			ar.write_data(reinterpret_cast<const byte*>(step.property->address(object)), step.size);
 		}
-		else if (ar.is_reading())
+
+		end_offset = ar.position() - start_pos;
+
+		ar.position(header_pos);
+		ar.serialize(data_offset, end_offset);
+		ar.write_data(reinterpret_cast<const byte*>(offsets.data()), offsets.size() * sizeof(size_t));
+		ar.position(start_pos + end_offset);
+		return ar;
+	}
+
+	bool Struct::load_properties(void* object, Archive& ar)
+	{
+		uint64_t layout_hash = 0;
+		ar.serialize(layout_hash);
+
+		if (!(layout_hash & layout_hash_bit))
 		{
-			size_t count = 0;
-			ar.serialize(count);
+			return load_tagged_properties(object, ar, layout_hash);
+		}
 
-			Vector<size_t> offsets(count + 1, 0);
-			auto start_pos = ar.position();
-			ar.read_data(reinterpret_cast<byte*>(offsets.data()), offsets.size() * sizeof(size_t));
+		size_t count       = 0;
+		size_t data_offset = 0;
+		size_t end_offset  = 0;
+		ar.serialize(count, data_offset, end_offset);
 
-			Name name;
+		const size_t start_pos        = ar.position();
+		const SerializationPlan& plan = serialization_plan(object);
 
-			for (size_t i = 0; i < count; ++i)
+		if (layout_hash == plan.layout_hash && count == plan.properties.size())
+		{
+			ar.position(start_pos + data_offset);
+
+			for (const SerializationStep& step : plan.steps)
 			{
-				ar.position(start_pos + offsets[i]);
+				if (step.size == 0)
+				{
+					step.property->serialize(object, ar);
+				}
+				else
+				{
+					ar.read_data(reinterpret_cast<byte*>(step.property->address(object)), step.size);
+				}
+			}
+		}
+		else
+		{
+			Vector<size_t> offsets(count, 0);
+			ar.read_data(reinterpret_cast<byte*>(offsets.data()), offsets.size() * sizeof(size_t));
+
+			Vector<Name> names(count);
 
+			for (Name& name : names)
+			{
 				name.serialize(ar);
-				Property* prop = find_property(name);
+			}
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				Property* prop = find_property(names[i]);
 
 				if (prop && prop->is_serializable())
 				{
+					ar.position(start_pos + offsets[i]);
 					prop->serialize(object, ar);
 				}
 			}
+		}
 
-			ar.position(start_pos + offsets.back());
+		ar.position(start_pos + end_offset);
+		return ar;
+	}
+
+	bool Struct::load_tagged_properties(void* object, Archive& ar, size_t count)
+	{
+		Vector<size_t> offsets(count + 1, 0);
+		auto start_pos = ar.position();
+		ar.read_data(reinterpret_cast<byte*>(offsets.data()), offsets.size() * sizeof(size_t));
+
+		Name name;
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			ar.position(start_pos + offsets[i]);
+
+			name.serialize(ar);
+			Property* prop = find_property(name);
+
+			if (prop && prop->is_serializable())
+			{
+				prop->serialize(object, ar);
+			}
+		}
+
+		ar.position(start_pos + offsets.back());
+		return ar;
+	}
+
+	bool Struct::serialize_properties(void* object, Archive& ar)
+	{
+		if (ar.is_saving())
+		{
+			save_properties(object, ar);
+		}
+		else if (ar.is_reading())
+		{
+			load_properties(object, ar);
 		}
 
 		auto scope = parent();
@@ -1,6 +1,8 @@
 #include <Core/memory.hpp>
 #include <Core/thread.hpp>
 #include <Core/threading.hpp>
+#include <chrono>
+#include <cstring>
 
 namespace Engine
 {
@@ -20,8 +22,8 @@ namespace Engine
 
 	Thread::Thread(NoThreadContext ctx)
 	{
-		m_read_pointer  = m_buffer;
-		m_write_pointer = m_buffer;
+		m_read_segment  = allocate_segment(m_segment_size);
+		m_write_segment = m_read_segment;
 	}
 
 	Thread::Thread() : Thread(NoThreadContext{})
@@ -29,31 +31,195 @@ namespace Engine
 		m_thread = new std::thread([this]() { thread_loop(); });
 	}
 
+	Thread::Segment* Thread::allocate_segment(size_t min_size)
+	{
+		if (min_size <= m_segment_size)
+		{
+			ScopeLock lock(m_free_segments_section);
+
+			if (Segment* segment = m_free_segments)
+			{
+				m_free_segments    = segment->next_free;
+				segment->next_free = nullptr;
+				return segment;
+			}
+		}
+
+		Segment* segment   = new Segment();
+		segment->reserved  = 0;
+		segment->next      = nullptr;
+		segment->next_free = nullptr;
+		segment->capacity  = glm::max(m_segment_size, align_memory(min_size, m_align));
+		segment->data      = static_cast<byte*>(::operator new(segment->capacity, std::align_val_t(m_align)));
+		std::memset(segment->data, 0, segment->capacity);
+
+		++m_segments_count;
+		return segment;
+	}
+
+	Thread& Thread::release_segment(Segment* segment)
+	{
+		if (segment->capacity == m_segment_size)
+		{
+			// Headers of the new commands can be placed over the old commands, so used memory must be cleared
+			std::memset(segment->data, 0, glm::min(segment->reserved.load(), segment->capacity));
+			segment->reserved = 0;
+			segment->next     = nullptr;
+
+			ScopeLock lock(m_free_segments_section);
+			segment->next_free = m_free_segments;
+			m_free_segments    = segment;
+		}
+		else
+		{
+			::operator delete(segment->data, std::align_val_t(m_align));
+			delete segment;
+			--m_segments_count;
+		}
+		return *this;
+	}
+
+	Thread& Thread::release_retired_segments()
+	{
+		while (Segment* segment = m_retired_segments)
+		{
+			m_retired_segments = segment->next_free;
+			release_segment(segment);
+		}
+		return *this;
+	}
+
+	Thread::Segment* Thread::next_segment(Segment* segment, size_t min_size)
+	{
+		auto start = std::chrono::steady_clock::now();
+
+		Segment* next = segment->next.load();
+
+		if (next == nullptr)
+		{
+			Segment* new_segment = allocate_segment(min_size);
+
+			if (segment->next.compare_exchange_strong(next, new_segment))
+			{
+				next = new_segment;
+			}
+			else
+			{
+				release_segment(new_segment);
+			}
+		}
+
+		m_write_segment.compare_exchange_strong(segment, next);
+
+		auto time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+		m_stall_time += time.count();
+		return next;
+	}
+
+	byte* Thread::reserve_command(size_t size)
+	{
+		const size_t slot_size = align_memory(sizeof(CommandHeader) + size, m_align);
+
+		// While producer holds pointer to the segment, consumer cannot reuse retired segments
+		++m_active_producers;
+
+		Segment* segment = m_write_segment.load();
+
+		while (true)
+		{
+			const size_t offset = segment->reserved.fetch_add(slot_size);
+
+			if (offset + slot_size <= segment->capacity)
+			{
+				CommandHeader* header = reinterpret_cast<CommandHeader*>(segment->data + offset);
+				header->size          = slot_size;
+
+				// Consumer cannot pass reserved slot until it is submitted, so segment is safe to use now
+				--m_active_producers;
+				return reinterpret_cast<byte*>(header + 1);
+			}
+
+			if (offset < segment->capacity)
+			{
+				CommandHeader* header = reinterpret_cast<CommandHeader*>(segment->data + offset);
+				header->state.store(CommandHeader::EndOfChain, std::memory_order_release);
+			}
+
+			segment = next_segment(segment, slot_size);
+		}
+	}
+
+	Thread& Thread::submit_command(byte* command)
+	{
+		CommandHeader* header = reinterpret_cast<CommandHeader*>(command) - 1;
+
+		const size_t pending = m_pending_commands.fetch_add(1);
+		header->state.store(CommandHeader::Ready, std::memory_order_release);
+
+		size_t max_pending = m_max_pending_commands.load(std::memory_order_relaxed);
+		while (max_pending <= pending && !m_max_pending_commands.compare_exchange_weak(max_pending, pending + 1))
+		{
+		}
+
+		if (pending == 0)
+		{
+			m_pending_commands.notify_one();
+		}
+
+		return *this;
+	}
+
 	Thread& Thread::execute_commands()
 	{
 		m_is_busy = true;
-		byte* wp  = m_write_pointer;
-		byte* rp  = m_read_pointer;
 
-		while (wp != rp)
+		Segment* segment = m_read_segment;
+		size_t offset    = m_read_offset;
+
+		while (true)
 		{
-			auto* task = reinterpret_cast<TaskInterface*>(rp);
-			auto size  = task->size();
-			task->execute();
-			std::destroy_at(task);
+			if (offset < segment->capacity)
+			{
+				CommandHeader* header = reinterpret_cast<CommandHeader*>(segment->data + offset);
+				auto state            = header->state.load(std::memory_order_acquire);
+
+				if (state == CommandHeader::Empty)
+					break;
+
+				if (state == CommandHeader::Ready)
+				{
+					auto* task = reinterpret_cast<TaskInterface*>(header + 1);
+					task->execute();
+					std::destroy_at(task);
 
-			rp = align_memory(rp + size, m_align);
+					offset += header->size;
+					header->state.store(CommandHeader::Empty, std::memory_order_relaxed);
+					--m_pending_commands;
+					continue;
+				}
+			}
+
+			Segment* next = segment->next.load();
 
-			if (rp >= m_buffer + m_buffer_size)
-				rp = m_buffer;
+			if (next == nullptr)
+				break;
 
-			m_read_pointer = rp;
+			segment->next_free = m_retired_segments;
+			m_retired_segments = segment;
+
+			segment = next;
+			offset  = 0;
 		}
 
-		m_is_busy = false;
-		m_exec_flag.clear();
-		m_exec_flag.notify_all();
+		m_read_segment = segment;
+		m_read_offset  = offset;
+
+		if (m_retired_segments && m_active_producers == 0)
+		{
+			release_retired_segments();
+		}
 
+		m_is_busy = false;
 		return *this;
 	}
 
@@ -63,15 +229,21 @@ namespace Engine
 
 		while (m_running)
 		{
-			while (m_running && m_read_pointer == m_write_pointer)
+			while (m_running && m_pending_commands == 0)
 			{
-				m_exec_flag.wait(false);
+				m_pending_commands.wait(0);
 			}
 
 			if (!m_running)
 				return;
 
 			execute_commands();
+
+			if (m_pending_commands > 0)
+			{
+				// Next command is reserved, but not submitted yet
+				std::this_thread::yield();
+			}
 		}
 	}
 
@@ -92,11 +264,40 @@ namespace Engine
 		return *this;
 	}
 
+	size_t Thread::queue_depth() const
+	{
+		return m_pending_commands;
+	}
+
+	size_t Thread::max_queue_depth() const
+	{
+		return m_max_pending_commands;
+	}
+
+	size_t Thread::producers_stall_time() const
+	{
+		return m_stall_time;
+	}
+
+	size_t Thread::segments_count() const
+	{
+		return m_segments_count;
+	}
+
+	Thread& Thread::reset_statistics()
+	{
+		m_max_pending_commands = m_pending_commands.load();
+		m_stall_time           = 0;
+		return *this;
+	}
+
 	Thread::~Thread()
 	{
 		m_running = false;
-		m_exec_flag.test_and_set();
-		m_exec_flag.notify_all();
+
+		// Wake up thread loop
+		++m_pending_commands;
+		m_pending_commands.notify_all();
 
 		if (m_thread)
 		{
@@ -107,6 +308,40 @@ namespace Engine
 
 			delete m_thread;
 		}
+
+		// Commands which were not executed are only destroyed, resources used by them can be already released
+		Segment* segment = m_read_segment;
+		size_t offset    = m_read_offset;
+
+		while (segment)
+		{
+			while (offset < segment->capacity)
+			{
+				CommandHeader* header = reinterpret_cast<CommandHeader*>(segment->data + offset);
+
+				if (header->state.load(std::memory_order_acquire) != CommandHeader::Ready)
+					break;
+
+				std::destroy_at(reinterpret_cast<TaskInterface*>(header + 1));
+				offset += header->size;
+			}
+
+			Segment* next      = segment->next;
+			offset             = 0;
+			segment->next_free = m_retired_segments;
+			m_retired_segments = segment;
+			segment            = next;
+		}
+
+		for (Segment* list : {m_retired_segments, m_free_segments})
+		{
+			while (Segment* segment = list)
+			{
+				list = segment->next_free;
+				::operator delete(segment->data, std::align_val_t(m_align));
+				delete segment;
+			}
+		}
 	}
 
 
@@ -1,9 +1,153 @@
 #include <Core/engine_loading_controllers.hpp>
+#include <Core/exception.hpp>
 #include <Core/thread_manager.hpp>
 
 namespace Engine
 {
-	static ThreadManager* m_manager = nullptr;
+	static constexpr size_t invalid_worker_index = ~static_cast<size_t>(0);
+
+	// Set in the count of jobs in flight while the queues are rebuilt, submission waits until it is cleared
+	static constexpr size_t resizing_flag = static_cast<size_t>(1) << (sizeof(size_t) * 8 - 1);
+
+	static ThreadManager* m_manager                  = nullptr;
+	static thread_local size_t m_current_worker_index = invalid_worker_index;
+
+	struct Job {
+		TaskInterface* m_task = nullptr;
+		Job* m_parent         = nullptr;
+
+		Atomic<int_t> m_references   = 1;
+		Atomic<int_t> m_unfinished   = 1;
+		Atomic<int_t> m_dependencies = 1;
+		Atomic<bool> m_is_finished   = false;
+
+		CriticalSection m_section;
+		Vector<Job*> m_continuations;
+
+		FORCE_INLINE void add_reference()
+		{
+			++m_references;
+		}
+
+		FORCE_INLINE void release()
+		{
+			if (m_references.fetch_sub(1) == 1)
+			{
+				delete m_task;
+				delete this;
+			}
+		}
+	};
+
+	JobHandle::JobHandle(Job* job) : m_job(job)
+	{
+		if (m_job)
+			m_job->add_reference();
+	}
+
+	JobHandle::JobHandle(const JobHandle& other) : JobHandle(other.m_job)
+	{}
+
+	JobHandle::JobHandle(JobHandle&& other) : m_job(other.m_job)
+	{
+		other.m_job = nullptr;
+	}
+
+	JobHandle& JobHandle::operator=(const JobHandle& other)
+	{
+		if (this != &other)
+		{
+			reset();
+			m_job = other.m_job;
+
+			if (m_job)
+				m_job->add_reference();
+		}
+		return *this;
+	}
+
+	JobHandle& JobHandle::operator=(JobHandle&& other)
+	{
+		if (this != &other)
+		{
+			reset();
+			m_job       = other.m_job;
+			other.m_job = nullptr;
+		}
+		return *this;
+	}
+
+	JobHandle::~JobHandle()
+	{
+		reset();
+	}
+
+	bool JobHandle::is_valid() const
+	{
+		return m_job != nullptr;
+	}
+
+	bool JobHandle::is_finished() const
+	{
+		return m_job == nullptr || m_job->m_is_finished.load();
+	}
+
+	JobHandle& JobHandle::reset()
+	{
+		if (m_job)
+		{
+			m_job->release();
+			m_job = nullptr;
+		}
+		return *this;
+	}
+
+	void ThreadManager::WorkerQueue::push(Job* job)
+	{
+		ScopeLock lock(m_section);
+
+		size_t capacity = m_jobs.size();
+
+		if (m_tail - m_head == capacity)
+		{
+			Vector<Job*> jobs(capacity == 0 ? 64 : capacity * 2);
+
+			for (size_t i = m_head; i < m_tail; ++i)
+			{
+				jobs[i - m_head] = m_jobs[i & (capacity - 1)];
+			}
+
+			m_tail -= m_head;
+			m_head = 0;
+			m_jobs = std::move(jobs);
+		}
+
+		m_jobs[m_tail & (m_jobs.size() - 1)] = job;
+		++m_tail;
+	}
+
+	Job* ThreadManager::WorkerQueue::pop()
+	{
+		ScopeLock lock(m_section);
+
+		if (m_head == m_tail)
+			return nullptr;
+
+		--m_tail;
+		return m_jobs[m_tail & (m_jobs.size() - 1)];
+	}
+
+	Job* ThreadManager::WorkerQueue::steal()
+	{
+		ScopeLock lock(m_section);
+
+		if (m_head == m_tail)
+			return nullptr;
+
+		Job* job = m_jobs[m_head & (m_jobs.size() - 1)];
+		++m_head;
+		return job;
+	}
 
 	ThreadManager* ThreadManager::instance()
 	{
@@ -14,66 +158,286 @@ namespace Engine
 		return m_manager;
 	}
 
+	size_t ThreadManager::default_threads_count()
+	{
+		// Logic and render threads are already running, so leave them their cores
+		size_t count = std::thread::hardware_concurrency();
+		return count > 2 ? count - 2 : 1;
+	}
+
+	size_t ThreadManager::worker_index()
+	{
+		return m_current_worker_index;
+	}
+
 	ThreadManager& ThreadManager::resize(size_t threads_count)
 	{
-		threads_count = glm::clamp<size_t>(1, std::thread::hardware_concurrency(), threads_count);
+		if (m_current_worker_index != invalid_worker_index)
+			throw EngineException("Cannot resize thread manager from the worker thread");
 
-		for (size_t i = 0; i < threads_count; ++i)
+		const size_t max_threads = glm::max<size_t>(1, std::thread::hardware_concurrency());
+		threads_count            = glm::clamp<size_t>(threads_count, 1, max_threads);
+
+		if (threads_count == m_threads.size())
+			return *this;
+
+		// Flag can be set only when there are no jobs, and it blocks new submissions until the queues are rebuilt
+		size_t in_flight = 0;
+		if (!m_jobs_in_flight.compare_exchange_strong(in_flight, resizing_flag))
+			throw EngineException("Cannot resize thread manager while jobs are in flight");
+
+		stop_workers();
+
+		// Queues are empty, because there are no jobs in flight
+		for (WorkerQueue* queue : m_queues)
 		{
-			m_threads.emplace_back(&ThreadManager::thread_loop, this);
+			delete queue;
 		}
+
+		m_queues.clear();
+		start_workers(threads_count);
+
+		m_jobs_in_flight = 0;
+		m_jobs_in_flight.notify_all();
 		return *this;
 	}
 
-	void ThreadManager::thread_loop()
+	size_t ThreadManager::threads_count() const
 	{
-		while (m_running)
+		return m_threads.size();
+	}
+
+	void ThreadManager::stop_workers()
+	{
+		m_running = false;
+		++m_wake_counter;
+		m_wake_counter.notify_all();
+
+		for (auto& thread : m_threads)
 		{
-			while (m_running && m_read_pointer == m_write_pointer)
+			if (thread.joinable())
 			{
-				m_has_tasks = false;
-				m_has_tasks.wait(false);
+				thread.join();
 			}
+		}
+
+		m_threads.clear();
+	}
+
+	void ThreadManager::start_workers(size_t threads_count)
+	{
+		m_running = true;
+
+		m_queues.reserve(threads_count);
+		for (size_t i = 0; i < threads_count; ++i)
+		{
+			m_queues.push_back(new WorkerQueue());
+		}
+
+		m_threads.reserve(threads_count);
+		for (size_t i = 0; i < threads_count; ++i)
+		{
+			m_threads.emplace_back(&ThreadManager::thread_loop, this, i);
+		}
+	}
 
-			if (!m_running)
-				return;
+	Job* ThreadManager::find_job(size_t queue_index)
+	{
+		const size_t count = m_queues.size();
+
+		if (queue_index < count)
+		{
+			if (Job* job = m_queues[queue_index]->pop())
+				return job;
+		}
+		else
+		{
+			queue_index = m_next_queue.load();
+		}
+
+		for (size_t i = 1; i <= count; ++i)
+		{
+			if (Job* job = m_queues[(queue_index + i) % count]->steal())
+				return job;
+		}
+
+		return nullptr;
+	}
+
+	ThreadManager& ThreadManager::schedule(Job* job)
+	{
+		size_t index = m_current_worker_index;
+
+		if (index >= m_queues.size())
+		{
+			index = m_next_queue.fetch_add(1) % m_queues.size();
+		}
+
+		m_queues[index]->push(job);
+		++m_wake_counter;
+		m_wake_counter.notify_one();
+		return *this;
+	}
+
+	ThreadManager& ThreadManager::execute(Job* job)
+	{
+		job->m_task->execute();
+		delete job->m_task;
+		job->m_task = nullptr;
+		return finish(job);
+	}
+
+	ThreadManager& ThreadManager::finish(Job* job)
+	{
+		if (job->m_unfinished.fetch_sub(1) != 1)
+			return *this;
+
+		Vector<Job*> continuations;
+		{
+			ScopeLock lock(job->m_section);
+			job->m_is_finished = true;
+			continuations      = std::move(job->m_continuations);
+		}
+
+		job->m_is_finished.notify_all();
+		--m_jobs_in_flight;
+
+		for (Job* continuation : continuations)
+		{
+			if (continuation->m_dependencies.fetch_sub(1) == 1)
+				schedule(continuation);
+		}
+
+		if (Job* parent = job->m_parent)
+		{
+			finish(parent);
+			parent->release();
+		}
+
+		job->release();
+		return *this;
+	}
+
+	JobHandle ThreadManager::submit(TaskInterface* task, const JobHandle* dependencies, size_t dependencies_count,
+	                                const JobHandle& parent)
+	{
+		size_t in_flight = m_jobs_in_flight.load();
+
+		while (true)
+		{
+			if (in_flight & resizing_flag)
+			{
+				m_jobs_in_flight.wait(in_flight);
+				in_flight = m_jobs_in_flight.load();
+			}
+			else if (m_jobs_in_flight.compare_exchange_weak(in_flight, in_flight + 1))
+			{
+				break;
+			}
+		}
 
+		Job* job    = new Job();
+		job->m_task = task;
 
-			// Load and unregister task from thread manager
-			m_thread_section.lock();
-			byte* rp = m_thread_read_pointer.load();
-			byte* wp = m_write_pointer;
+		if (Job* parent_job = parent.m_job)
+		{
+			// Attach only to the parent which is still running, finished parent cannot wait for new children
+			int_t unfinished = parent_job->m_unfinished.load();
+			while (unfinished > 0 && !parent_job->m_unfinished.compare_exchange_weak(unfinished, unfinished + 1))
+			{
+			}
 
-			if (rp == wp)
+			if (unfinished > 0)
 			{
-				m_thread_section.unlock();
+				parent_job->add_reference();
+				job->m_parent = parent_job;
+			}
+		}
+
+		for (size_t i = 0; i < dependencies_count; ++i)
+		{
+			Job* dependency = dependencies[i].m_job;
+
+			if (dependency == nullptr)
 				continue;
+
+			ScopeLock lock(dependency->m_section);
+
+			if (!dependency->m_is_finished)
+			{
+				++job->m_dependencies;
+				dependency->m_continuations.push_back(job);
 			}
+		}
 
-			TaskInterface* task    = reinterpret_cast<TaskInterface*>(m_thread_read_pointer.load());
-			const size_t task_size = task->size();
-			rp                     = align_memory(rp + task_size, m_align);
+		JobHandle handle(job);
 
-			if (rp >= m_buffer + m_buffer_size)
-				rp = m_buffer;
+		if (job->m_dependencies.fetch_sub(1) == 1)
+			schedule(job);
 
-			m_thread_read_pointer = rp;
-			m_thread_section.unlock();
+		return handle;
+	}
+
+	ThreadManager& ThreadManager::wait(const JobHandle& handle)
+	{
+		Job* job = handle.m_job;
 
-			task->execute();
+		if (job == nullptr)
+			return *this;
 
-			// Submit executed task
+		// Logic and render threads don't execute queued jobs, otherwise they could run unrelated long jobs or each other's
+		// work. They are blocked until the workers finish the job
+		if (m_current_worker_index == invalid_worker_index)
+		{
+			while (!job->m_is_finished.load())
 			{
-				m_thread_section.lock();
-				rp = align_memory(m_read_pointer.load() + task_size, m_align);
+				job->m_is_finished.wait(false);
+			}
+			return *this;
+		}
 
-				if (rp >= m_buffer + m_buffer_size)
-					rp = m_buffer;
+		while (!job->m_is_finished.load())
+		{
+			if (Job* other = find_job(m_current_worker_index))
+			{
+				execute(other);
+			}
+			else
+			{
+				std::this_thread::yield();
+			}
+		}
+		return *this;
+	}
+
+	ThreadManager& ThreadManager::wait(std::initializer_list<JobHandle> handles)
+	{
+		for (const JobHandle& handle : handles)
+		{
+			wait(handle);
+		}
+		return *this;
+	}
+
+	void ThreadManager::thread_loop(size_t index)
+	{
+		m_current_worker_index = index;
+
+		while (m_running)
+		{
+			size_t wake_counter = m_wake_counter.load();
 
-				m_read_pointer = rp;
-				m_thread_section.unlock();
+			if (Job* job = find_job(index))
+			{
+				execute(job);
+			}
+			else if (m_running)
+			{
+				m_wake_counter.wait(wake_counter);
 			}
 		}
+
+		m_current_worker_index = invalid_worker_index;
 	}
 
 	void ThreadManager::destroy_manager()
@@ -85,25 +449,20 @@ namespace Engine
 	ThreadManager::ThreadManager()
 	{
 		PostDestroyController().push(destroy_manager);
-
-		m_read_pointer        = m_buffer;
-		m_thread_read_pointer = m_buffer;
-		m_write_pointer       = m_buffer;
-		resize(10);
+		start_workers(default_threads_count());
 	}
 
 	ThreadManager::~ThreadManager()
 	{
-		m_running   = false;
-		m_has_tasks = true;
-		m_has_tasks.notify_all();
+		stop_workers();
 
-		for (auto& thread : m_threads)
+		for (WorkerQueue* queue : m_queues)
 		{
-			if (thread.joinable())
+			while (Job* job = queue->steal())
 			{
-				thread.join();
+				job->release();
 			}
+			delete queue;
 		}
 	}
 }// namespace Engine
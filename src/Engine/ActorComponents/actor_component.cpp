@@ -1,5 +1,6 @@
 #include <Core/etl/templates.hpp>
 #include <Core/reflection/class.hpp>
+#include <Core/threading.hpp>
 #include <Engine/ActorComponents/actor_component.hpp>
 #include <Engine/Actors/actor.hpp>
 #include <ScriptEngine/registrar.hpp>
@@ -79,7 +80,8 @@ namespace Engine
 	{
 		if (m_proxy)
 		{
-			delete m_proxy;
+			// Frames which are in flight can still use this proxy, so it must be destroyed by the render thread
+			call_in_render_thread([proxy = m_proxy]() { delete proxy; });
 			m_proxy = nullptr;
 		}
 	}
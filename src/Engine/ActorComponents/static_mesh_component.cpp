@@ -42,11 +42,13 @@ namespace Engine
 
 		StaticMesh* mesh   = component->mesh;
 		auto& camera_view  = scene_view().camera_view();
-		float inv_distance = 1.f / glm::min(glm::distance(component->proxy()->world_transform().location(), camera_view.location),
-		                                    camera_view.far_clip_plane);
+		float distance     = glm::min(glm::distance(component->proxy()->world_transform().location(), camera_view.location),
+		                              camera_view.far_clip_plane);
+		float inv_distance = 1.f / distance;
 		auto& lods         = mesh->lods;
 		Index lod_index    = glm::min<Index>(static_cast<Index>(static_cast<float>(lods.size()) * inv_distance), lods.size() - 1);
 		auto& lod          = lods[lod_index];
+		auto pass          = geometry_pass();
 
 		for (auto& material : mesh->materials)
 		{
@@ -55,10 +57,13 @@ namespace Engine
 				continue;
 			}
 
-			auto pass = geometry_pass();
-			pass->bind_material(material.material, component);
-
 			VertexShader* shader = material.material->material()->pipeline->vertex_shader();
+			auto streams         = FrameArena::instance().allocate_array<RenderPass::VertexStream>(shader->attributes.size());
+
+			RenderPass::MeshDraw draw;
+			draw.material  = material.material;
+			draw.component = component;
+			draw.streams   = streams;
 
 			for (Index i = 0, count = shader->attributes.size(); i < count; ++i)
 			{
@@ -67,21 +72,22 @@ namespace Engine
 
 				if (buffer)
 				{
-					pass->bind_vertex_buffer(buffer, attribute.stream_index, 0);
+					streams[draw.streams_count++] = {buffer, 0, attribute.stream_index};
 				}
 			}
 
-			auto& surface = lod.surfaces[material.surface_index];
+			auto& surface       = lod.surfaces[material.surface_index];
+			draw.vertices_count = surface.vertices_count;
+			draw.base_vertex    = surface.base_vertex_index;
 
 			if (lod.indices->size() > 0)
 			{
-				pass->bind_index_buffer(lod.indices, 0);
-				pass->draw_indexed(surface.vertices_count, surface.first_index, surface.base_vertex_index);
-			}
-			else
-			{
-				pass->draw(surface.vertices_count, surface.base_vertex_index);
+				draw.index_buffer = lod.indices;
+				draw.first_index  = surface.first_index;
 			}
+
+			draw.sort_key = draw.build_sort_key(distance / camera_view.far_clip_plane);
+			pass->draw_mesh(draw);
 		}
 
 		return *this;
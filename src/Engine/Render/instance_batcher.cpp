@@ -0,0 +1,198 @@
+#include <Core/etl/frame_allocator.hpp>
+#include <Core/etl/map.hpp>
+#include <Core/memory.hpp>
+#include <Core/parallel.hpp>
+#include <Engine/ActorComponents/scene_component.hpp>
+#include <Engine/Render/instance_batcher.hpp>
+#include <Graphics/material.hpp>
+#include <Graphics/pipeline.hpp>
+#include <Graphics/shader.hpp>
+
+namespace Engine
+{
+	static HashIndex surface_hash_of(const RenderPass::MeshDraw* draw)
+	{
+		const void* state[]  = {draw->material, draw->index_buffer};
+		const size_t range[] = {draw->vertices_count, draw->first_index, draw->base_vertex};
+
+		HashIndex hash = memory_hash_fast(state, sizeof(state));
+		hash           = memory_hash_fast(range, sizeof(range), hash);
+
+		// Streams are hashed by fields, because padding of the stream structure is not initialized
+		for (size_t i = 0; i < draw->streams_count; ++i)
+		{
+			const RenderPass::VertexStream& stream = draw->streams[i];
+
+			hash = memory_hash_fast(&stream.buffer, sizeof(stream.buffer), hash);
+			hash = memory_hash_fast(&stream.stream, sizeof(stream.stream), hash);
+		}
+
+		return hash;
+	}
+
+	static bool is_same_surface(const RenderPass::MeshDraw* a, const RenderPass::MeshDraw* b)
+	{
+		if (a->material != b->material || a->index_buffer != b->index_buffer || a->vertices_count != b->vertices_count ||
+		    a->first_index != b->first_index || a->base_vertex != b->base_vertex || a->streams_count != b->streams_count)
+			return false;
+
+		for (size_t i = 0; i < a->streams_count; ++i)
+		{
+			const RenderPass::VertexStream& stream = a->streams[i];
+			const RenderPass::VertexStream& other  = b->streams[i];
+
+			if (stream.buffer != other.buffer || stream.offset != other.offset || stream.stream != other.stream)
+				return false;
+		}
+
+		return true;
+	}
+
+	InstanceBatcher::InstanceBatcher()
+	{
+		m_buffer = Object::new_instance<TransformDynamicVertexBuffer>();
+		m_buffer->allocate_data(true);
+	}
+
+	bool InstanceBatcher::is_instanced(MaterialInterface* material)
+	{
+		Material* base = material ? material->material() : nullptr;
+
+		if (base == nullptr || base->pipeline == nullptr)
+			return false;
+
+		VertexShader* shader = base->pipeline->vertex_shader();
+
+		if (shader == nullptr)
+			return false;
+
+		for (auto& attribute : shader->attributes)
+		{
+			if (attribute.semantic == VertexBufferSemantic::Transform)
+				return true;
+		}
+
+		return false;
+	}
+
+	InstanceBatcher& InstanceBatcher::add(const RenderPass::MeshDraw* const* draws, size_t count)
+	{
+		const size_t first_batch = m_batches.size();
+
+		Map<HashIndex, size_t> surfaces;
+		Map<MaterialInterface*, bool> instanced_materials;
+		FrameVector<size_t> batch_of(count);
+
+		// Count instances of each batch first, so that instances of one batch are placed contiguously
+		for (size_t index = 0; index < count; ++index)
+		{
+			const RenderPass::MeshDraw* draw = draws[index];
+
+			auto material = instanced_materials.find(draw->material);
+
+			if (material == instanced_materials.end())
+				material = instanced_materials.emplace(draw->material, is_instanced(draw->material)).first;
+
+			if (material->second)
+			{
+				const HashIndex hash = surface_hash_of(draw);
+				auto it              = surfaces.find(hash);
+
+				if (it != surfaces.end() && is_same_surface(m_batches[it->second].draw, draw))
+				{
+					++m_batches[it->second].instances_count;
+					batch_of[index] = it->second;
+					continue;
+				}
+
+				surfaces[hash] = m_batches.size();
+			}
+
+			batch_of[index] = m_batches.size();
+			m_batches.push_back({draw, 0, 1, material->second});
+		}
+
+		size_t offset = m_instances.size();
+
+		for (size_t index = first_batch; index < m_batches.size(); ++index)
+		{
+			Batch& batch         = m_batches[index];
+			batch.first_instance = offset;
+			offset += batch.instances_count;
+			batch.instances_count = 0;
+		}
+
+		m_instances.resize(offset);
+
+		for (size_t index = 0; index < count; ++index)
+		{
+			Batch& batch                                                 = m_batches[batch_of[index]];
+			m_instances[batch.first_instance + batch.instances_count++] = draws[index];
+		}
+
+		return *this;
+	}
+
+	InstanceBatcher& InstanceBatcher::submit()
+	{
+		const size_t count = m_instances.size();
+
+		if (count == 0)
+			return *this;
+
+		auto columns = m_buffer->buffer();
+		columns->resize(count * 4);
+
+		parallel_for(count, 256, [&](size_t begin, size_t end) {
+			for (size_t index = begin; index < end; ++index)
+			{
+				const Matrix4f matrix = m_instances[index]->component->proxy()->world_transform().matrix();
+
+				for (byte column = 0; column < 4; ++column)
+				{
+					(*columns)[column * count + index] = matrix[column];
+				}
+			}
+		});
+
+		const size_t size = columns->size() * sizeof(Vector4D);
+
+		if (size <= m_buffer->size())
+		{
+			m_buffer->rhi_update(0, size, m_buffer->data());
+		}
+		else
+		{
+			m_buffer->rhi_init();
+		}
+
+		return *this;
+	}
+
+	InstanceBatcher& InstanceBatcher::clear()
+	{
+		m_batches.clear();
+		m_instances.clear();
+		return *this;
+	}
+
+	const Vector<InstanceBatcher::Batch>& InstanceBatcher::batches() const
+	{
+		return m_batches;
+	}
+
+	const Vector<const RenderPass::MeshDraw*>& InstanceBatcher::instances() const
+	{
+		return m_instances;
+	}
+
+	TransformDynamicVertexBuffer* InstanceBatcher::instance_buffer() const
+	{
+		return m_buffer.ptr();
+	}
+
+	size_t InstanceBatcher::column_offset(size_t instance, byte column) const
+	{
+		return (column * m_instances.size() + instance) * sizeof(Vector4D);
+	}
+}// namespace Engine
@@ -3,24 +3,71 @@
 #include <Core/reflection/render_pass_info.hpp>
 #include <Engine/ActorComponents/light_component.hpp>
 #include <Engine/ActorComponents/primitive_component.hpp>
+#include <Engine/Render/instance_batcher.hpp>
 #include <Engine/Render/render_pass.hpp>
 #include <Engine/Render/scene_renderer.hpp>
 #include <Engine/scene.hpp>
 #include <Graphics/gpu_buffers.hpp>
 #include <Graphics/material.hpp>
 #include <Graphics/material_parameter.hpp>
+#include <Graphics/pipeline.hpp>
 #include <Graphics/rhi.hpp>
 #include <Graphics/scene_render_targets.hpp>
+#include <Graphics/shader.hpp>
 
 namespace Engine
 {
 	implement_struct_default_init(Engine::RenderPass, 0);
 
-	RenderPass::RenderPass()
+	static thread_local RenderCommandList* current_command_list = nullptr;
+
+	RenderCommandList::Scope::Scope(RenderCommandList* list) : m_previous(current_command_list)
+	{
+		current_command_list = list;
+	}
+
+	RenderCommandList::Scope::~Scope()
+	{
+		current_command_list = m_previous;
+	}
+
+	RenderCommandList* RenderCommandList::current()
+	{
+		return current_command_list;
+	}
+
+	Vector<RenderPass::Command>& RenderCommandList::commands_of(RenderPass* pass)
+	{
+		// Renderer has only a few passes, so linear search is faster than the map
+		for (auto& [owner, commands] : m_commands)
+		{
+			if (owner == pass)
+				return commands;
+		}
+
+		return m_commands.emplace_back(pass, Vector<RenderPass::Command>()).second;
+	}
+
+	RenderCommandList& RenderCommandList::submit()
+	{
+		for (auto& [pass, commands] : m_commands)
+		{
+			pass->m_commands.insert(pass->m_commands.end(), commands.begin(), commands.end());
+		}
+
+		m_commands.clear();
+		return *this;
+	}
+
+	// Instance buffer is an object, so it is created together with the pass in the logic thread
+	RenderPass::RenderPass() : m_instances(new InstanceBatcher())
 	{}
 
 	RenderPass::~RenderPass()
 	{
+		release_commands();
+		delete m_instances;
+
 		if (m_next)
 			delete m_next;
 	}
@@ -37,15 +84,35 @@ namespace Engine
 
 	bool RenderPass::is_empty() const
 	{
-		return m_allocated == 0;
+		return m_commands.empty();
 	}
 
-	RenderPass& RenderPass::clear()
+	Vector<RenderPass::Command>& RenderPass::commands()
 	{
-		m_allocated = 0;
+		if (RenderCommandList* list = current_command_list)
+			return list->commands_of(this);
+		return m_commands;
+	}
+
+	RenderPass& RenderPass::release_commands()
+	{
+		for (Command& command : m_commands)
+		{
+			if (command.task)
+				command.task->~TaskInterface();
+		}
+
+		m_commands.clear();
+		m_instances->clear();
+
 		return *this;
 	}
 
+	RenderPass& RenderPass::clear()
+	{
+		return release_commands();
+	}
+
 	template<typename NodeType>
 	static void render_octree_bounding_box(NodeType* node, BatchedLines& lines)
 	{
@@ -61,16 +128,264 @@ namespace Engine
 	}
 
 
+	static FORCE_INLINE uint64_t sort_key_bits(const void* address)
+	{
+		// Fibonacci hashing spreads addresses of the objects allocated close to each other over the whole 16 bit range
+		return (reinterpret_cast<uintptr_t>(address) * 0x9E3779B97F4A7C15ULL) >> 48;
+	}
+
+	uint64_t RenderPass::MeshDraw::build_sort_key(float depth) const
+	{
+		Material* base          = material ? material->material() : nullptr;
+		VertexBuffer* vertices  = streams_count > 0 ? streams[0].buffer : nullptr;
+		const uint64_t pipeline = base ? sort_key_bits(base->pipeline) : 0;
+		const uint64_t buffers  = sort_key_bits(index_buffer) ^ sort_key_bits(vertices);
+		const uint64_t distance = static_cast<uint64_t>(glm::clamp(depth, 0.f, 1.f) * 65535.f);
+
+		return (pipeline << 48) | (sort_key_bits(material) << 32) | (buffers << 16) | distance;
+	}
+
+	struct DrawSortEntry {
+		uint64_t key;
+		const RenderPass::MeshDraw* draw;
+	};
+
+	// Stable sort of the draws by keys. Least significant digit radix sort is used for large ranges, passes where all keys
+	// have the same digit are skipped. Clearing of the histograms costs more than comparison sort of small ranges
+	static void sort_draws(FrameVector<DrawSortEntry>& entries)
+	{
+		static constexpr size_t radix_sort_threshold = 1024;
+		const size_t count                           = entries.size();
+
+		if (count < radix_sort_threshold)
+		{
+			std::stable_sort(entries.begin(), entries.end(),
+			                 [](const DrawSortEntry& a, const DrawSortEntry& b) { return a.key < b.key; });
+			return;
+		}
+
+		size_t histograms[8][256] = {};
+
+		for (const DrawSortEntry& entry : entries)
+		{
+			for (uint_t digit = 0; digit < 8; ++digit)
+			{
+				++histograms[digit][(entry.key >> (digit * 8)) & 0xFF];
+			}
+		}
+
+		FrameVector<DrawSortEntry> sorted(count);
+
+		for (uint_t digit = 0; digit < 8; ++digit)
+		{
+			size_t* histogram  = histograms[digit];
+			const uint_t shift = digit * 8;
+
+			if (histogram[(entries[0].key >> shift) & 0xFF] == count)
+				continue;
+
+			for (size_t bucket = 0, offset = 0; bucket < 256; ++bucket)
+			{
+				const size_t size = histogram[bucket];
+				histogram[bucket] = offset;
+				offset += size;
+			}
+
+			for (const DrawSortEntry& entry : entries)
+			{
+				sorted[histogram[(entry.key >> shift) & 0xFF]++] = entry;
+			}
+
+			entries.swap(sorted);
+		}
+	}
+
+	RenderPass& RenderPass::batch_draws(const Command* begin, const Command* end)
+	{
+		FrameVector<DrawSortEntry> entries;
+		entries.reserve(end - begin);
+
+		for (const Command* command = begin; command != end; ++command)
+		{
+			entries.push_back({command->draw->sort_key, command->draw});
+		}
+
+		sort_draws(entries);
+
+		FrameVector<const MeshDraw*> draws;
+		draws.reserve(entries.size());
+
+		for (const DrawSortEntry& entry : entries)
+		{
+			draws.push_back(entry.draw);
+		}
+
+		m_instances->add(draws.data(), draws.size());
+		return *this;
+	}
+
+	RenderPass& RenderPass::execute_batches(size_t begin, size_t end)
+	{
+		RenderStatistics& statistics = m_renderer->statistics;
+		Pipeline* pipeline           = nullptr;
+		MaterialInterface* material  = nullptr;
+		SceneComponent* component    = nullptr;
+		IndexBuffer* index_buffer    = nullptr;
+		FrameVector<VertexStream> bound_streams;
+
+		auto& batches = m_instances->batches();
+
+		for (size_t index = begin; index < end; ++index)
+		{
+			const InstanceBatcher::Batch& batch = batches[index];
+			const MeshDraw* draw                = batch.draw;
+			Material* base                      = draw->material->material();
+
+			if (base == nullptr)
+				continue;
+
+			// RHI keeps the pipeline bound, but buffer bindings may belong to the pipeline state, like vertex arrays in OpenGL
+			if (base->pipeline != pipeline)
+			{
+				pipeline     = base->pipeline;
+				index_buffer = nullptr;
+				bound_streams.clear();
+			}
+
+			if (draw->material == material && draw->component == component)
+			{
+				++statistics.material_binds_skipped;
+			}
+			else
+			{
+				draw->material->apply(draw->component, this);
+				material  = draw->material;
+				component = draw->component;
+			}
+
+			for (size_t i = 0; i < draw->streams_count; ++i)
+			{
+				const VertexStream& stream = draw->streams[i];
+
+				if (stream.stream >= bound_streams.size())
+					bound_streams.resize(stream.stream + 1, {nullptr, 0, 0});
+
+				VertexStream& bound = bound_streams[stream.stream];
+
+				if (bound.buffer == stream.buffer && bound.offset == stream.offset)
+				{
+					++statistics.buffer_binds_skipped;
+					continue;
+				}
+
+				bound = stream;
+				stream.buffer->rhi_bind(stream.stream, stream.offset);
+			}
+
+			if (batch.is_instanced)
+			{
+				TransformDynamicVertexBuffer* instances = m_instances->instance_buffer();
+
+				for (auto& attribute : pipeline->vertex_shader()->attributes)
+				{
+					if (attribute.semantic != VertexBufferSemantic::Transform)
+						continue;
+
+					const size_t offset = m_instances->column_offset(batch.first_instance, attribute.semantic_index);
+
+					if (attribute.stream_index >= bound_streams.size())
+						bound_streams.resize(attribute.stream_index + 1, {nullptr, 0, 0});
+
+					bound_streams[attribute.stream_index] = {instances, offset, attribute.stream_index};
+					instances->rhi_bind(attribute.stream_index, offset);
+				}
+
+				if (batch.instances_count > 1)
+				{
+					++statistics.instanced_draws;
+					statistics.instances += batch.instances_count;
+				}
+			}
+
+			if (draw->index_buffer)
+			{
+				if (draw->index_buffer == index_buffer)
+				{
+					++statistics.buffer_binds_skipped;
+				}
+				else
+				{
+					index_buffer = draw->index_buffer;
+					index_buffer->rhi_bind(0);
+				}
+
+				if (batch.is_instanced)
+					rhi->draw_indexed_instanced(draw->vertices_count, draw->first_index, draw->base_vertex, batch.instances_count);
+				else
+					rhi->draw_indexed(draw->vertices_count, draw->first_index, draw->base_vertex);
+			}
+			else
+			{
+				if (batch.is_instanced)
+					rhi->draw_instanced(draw->vertices_count, draw->base_vertex, batch.instances_count);
+				else
+					rhi->draw(draw->vertices_count, draw->base_vertex);
+			}
+		}
+
+		return *this;
+	}
+
 	RenderPass& RenderPass::render(RenderViewport* render_target)
 	{
-		size_t offset = 0;
-		byte* data    = m_commands.data();
+		const Command* begin = m_commands.data();
+		const Command* end   = begin + m_commands.size();
+
+		// Draws of all ranges are grouped before execution, so the instance buffer is written once per frame
+		FrameVector<size_t> batches_end;
+
+		for (const Command* command = begin; command != end;)
+		{
+			if (command->task)
+			{
+				++command;
+				continue;
+			}
+
+			const Command* draws_end = command + 1;
+
+			while (draws_end != end && draws_end->task == nullptr)
+			{
+				++draws_end;
+			}
 
-		while (offset < m_allocated)
+			batch_draws(command, draws_end);
+			batches_end.push_back(m_instances->batches().size());
+			command = draws_end;
+		}
+
+		if (!batches_end.empty())
+			m_instances->submit();
+
+		size_t range         = 0;
+		size_t batches_begin = 0;
+
+		for (const Command* command = begin; command != end;)
 		{
-			TaskInterface* task = reinterpret_cast<TaskInterface*>(data + offset);
-			offset += task->size();
-			task->execute();
+			if (command->task)
+			{
+				command->task->execute();
+				++command;
+				continue;
+			}
+
+			while (command != end && command->task == nullptr)
+			{
+				++command;
+			}
+
+			execute_batches(batches_begin, batches_end[range]);
+			batches_begin = batches_end[range++];
 		}
 
 		return *this;
@@ -214,6 +529,12 @@ namespace Engine
 		return *this;
 	}
 
+	RenderPass& RenderPass::draw_mesh(const MeshDraw& draw)
+	{
+		commands().push_back({nullptr, FrameArena::instance().create<MeshDraw>(draw)});
+		return *this;
+	}
+
 	// IMPLEMENTATION OF RENDER PASSES
 
 	trinex_impl_render_pass(Engine::ClearPass)
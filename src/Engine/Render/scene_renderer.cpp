@@ -1,5 +1,6 @@
 #include <Core/base_engine.hpp>
 #include <Core/default_resources.hpp>
+#include <Core/etl/frame_allocator.hpp>
 #include <Core/etl/templates.hpp>
 #include <Core/logger.hpp>
 #include <Core/reflection/struct.hpp>
@@ -42,6 +43,8 @@ namespace Engine
 		}
 	};
 
+	// Uniform buffers of the global parameters are RHI resources, so they are pooled between frames instead of being
+	// allocated from the frame arena. The stack itself is linked through the buffers and doesn't allocate
 	class GlobalShaderParametersManager
 	{
 		Vector<GlobalUniformBuffer*> m_uniform_buffers;
@@ -102,7 +105,8 @@ namespace Engine
 			{
 				m_uniform_buffers.push_back(buffer);
 			}
-			m_uniform_buffers.clear();
+			m_used_buffers.clear();
+			m_current = nullptr;
 			return *this;
 		}
 
@@ -312,12 +316,28 @@ namespace Engine
 #endif
 		}
 
+		// Commands live in the frame arena, so they cannot be kept until the next frame
+		for (auto pass = first_pass(); pass; pass = pass->next())
+		{
+			pass->release_commands();
+		}
+
+		// Commands are recorded by the worker threads too, so the arenas of all threads are counted
+		const FrameArena::Statistics arena_statistics = FrameArena::statistics();
+		statistics.frame_allocations                  = arena_statistics.allocations;
+		statistics.peak_arena_usage                   = arena_statistics.peak_usage;
+
 		pop_global_parameters();
 		m_scene_views.pop_back();
 
 		return *this;
 	}
 
+	bool SceneRenderer::supports_parallel_recording() const
+	{
+		return false;
+	}
+
 	SceneRenderer& SceneRenderer::render_component(PrimitiveComponent* component)
 	{
 		return *this;
@@ -344,4 +364,9 @@ namespace Engine
 		m_post_process_pass      = create_pass<PostProcessPass>();
 		m_overlay_pass           = create_pass<OverlayPass>();
 	}
+
+	bool ColorSceneRenderer::supports_parallel_recording() const
+	{
+		return true;
+	}
 }// namespace Engine
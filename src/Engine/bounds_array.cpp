@@ -0,0 +1,83 @@
+#include <Engine/aabb.hpp>
+#include <Engine/bounds_array.hpp>
+
+namespace Engine
+{
+	size_t BoundsArray::size() const
+	{
+		return m_centers[0].size();
+	}
+
+	bool BoundsArray::empty() const
+	{
+		return m_centers[0].empty();
+	}
+
+	BoundsArray& BoundsArray::reserve(size_t size)
+	{
+		for (size_t axis = 0; axis < 3; ++axis)
+		{
+			m_centers[axis].reserve(size);
+			m_extents[axis].reserve(size);
+		}
+		return *this;
+	}
+
+	BoundsArray& BoundsArray::clear()
+	{
+		for (size_t axis = 0; axis < 3; ++axis)
+		{
+			m_centers[axis].clear();
+			m_extents[axis].clear();
+		}
+		return *this;
+	}
+
+	BoundsArray& BoundsArray::push(const AABB_3Df& box)
+	{
+		const Vector3D center  = box.center();
+		const Vector3D extents = box.max() - center;
+
+		for (size_t axis = 0; axis < 3; ++axis)
+		{
+			m_centers[axis].push_back(center[axis]);
+			m_extents[axis].push_back(extents[axis]);
+		}
+		return *this;
+	}
+
+	BoundsArray& BoundsArray::set(size_t index, const AABB_3Df& box)
+	{
+		const Vector3D center  = box.center();
+		const Vector3D extents = box.max() - center;
+
+		for (size_t axis = 0; axis < 3; ++axis)
+		{
+			m_centers[axis][index] = center[axis];
+			m_extents[axis][index] = extents[axis];
+		}
+		return *this;
+	}
+
+	BoundsArray& BoundsArray::remove_swap(size_t index)
+	{
+		for (size_t axis = 0; axis < 3; ++axis)
+		{
+			m_centers[axis][index] = m_centers[axis].back();
+			m_extents[axis][index] = m_extents[axis].back();
+			m_centers[axis].pop_back();
+			m_extents[axis].pop_back();
+		}
+		return *this;
+	}
+
+	const float* BoundsArray::centers(size_t axis) const
+	{
+		return m_centers[axis].data();
+	}
+
+	const float* BoundsArray::extents(size_t axis) const
+	{
+		return m_extents[axis].data();
+	}
+}// namespace Engine
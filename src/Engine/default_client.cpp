@@ -29,7 +29,9 @@ namespace Engine
 	{
 		if (engine_instance->frame_index() % 100 == 0)
 		{
-			info_log("FPS", "%f\n", 1.0 / dt);
+			auto& stats = engine_instance->frame_statistics();
+			info_log("FPS", "%f (logic: %.2f ms, render: %.2f ms, wait: %.2f ms, overlap: %.0f%%)\n", 1.0 / dt,
+			         stats.logic_time * 1000.f, stats.render_time * 1000.f, stats.wait_time * 1000.f, stats.overlap * 100.f);
 		}
 		return *this;
 	}
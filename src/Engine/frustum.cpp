@@ -1,8 +1,15 @@
 #include <Core/constants.hpp>
 #include <Engine/aabb.hpp>
+#include <Engine/bounds_array.hpp>
 #include <Engine/camera_types.hpp>
 #include <Engine/frustum.hpp>
 
+#if ARCH_X86_64
+#include <emmintrin.h>
+#elif ARCH_ARM && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 namespace Engine
 {
 	Plane::Plane() : normal(Constants::zero_vector), distance(0.f)
@@ -53,13 +60,163 @@ namespace Engine
 
 	bool Frustum::in_frustum(const AABB_3Df& box) const
 	{
-		bool r1 = left.is_on_or_forward(box);
-		bool r2 = right.is_on_or_forward(box);
-		bool r3 = top.is_on_or_forward(box);
-		bool r4 = bottom.is_on_or_forward(box);
-		bool r5 = near.is_on_or_forward(box);
-		bool r6 = far.is_on_or_forward(box);
-
-		return r1 && r2 && r3 && r4 && r5 && r6;
+		const Vector3D center  = box.center();
+		const Vector3D extents = box.max() - center;
+
+		for (const Plane* plane : {&left, &right, &top, &bottom, &near, &far})
+		{
+			const float r = glm::dot(extents, glm::abs(plane->normal));
+
+			if (plane->signed_distance_to_plane(center) < -r)
+				return false;
+		}
+
+		return true;
+	}
+
+	namespace
+	{
+		struct FrustumPlanes {
+			float normal[3][6];
+			float abs_normal[3][6];
+			float distance[6];
+
+			FrustumPlanes(const Frustum& frustum)
+			{
+				const Plane* planes[6] = {&frustum.left,   &frustum.right, &frustum.top,
+				                          &frustum.bottom, &frustum.near,  &frustum.far};
+
+				for (size_t plane = 0; plane < 6; ++plane)
+				{
+					for (size_t axis = 0; axis < 3; ++axis)
+					{
+						normal[axis][plane]     = planes[plane]->normal[axis];
+						abs_normal[axis][plane] = glm::abs(planes[plane]->normal[axis]);
+					}
+
+					distance[plane] = planes[plane]->distance;
+				}
+			}
+		};
+	}// namespace
+
+	static FORCE_INLINE bool is_box_visible(const FrustumPlanes& planes, const BoundsArray& bounds, size_t index)
+	{
+		const float cx = bounds.centers(0)[index];
+		const float cy = bounds.centers(1)[index];
+		const float cz = bounds.centers(2)[index];
+		const float ex = bounds.extents(0)[index];
+		const float ey = bounds.extents(1)[index];
+		const float ez = bounds.extents(2)[index];
+
+		for (size_t plane = 0; plane < 6; ++plane)
+		{
+			const float distance =
+			        planes.normal[0][plane] * cx + planes.normal[1][plane] * cy + planes.normal[2][plane] * cz - planes.distance[plane];
+			const float r = planes.abs_normal[0][plane] * ex + planes.abs_normal[1][plane] * ey + planes.abs_normal[2][plane] * ez;
+
+			if (distance + r < 0.f)
+				return false;
+		}
+
+		return true;
+	}
+
+	// Returns mask of the visible boxes [index, index + 4)
+	static FORCE_INLINE uint64_t visible_boxes_x4(const FrustumPlanes& planes, const BoundsArray& bounds, size_t index)
+	{
+#if ARCH_X86_64
+		const __m128 cx = _mm_loadu_ps(bounds.centers(0) + index);
+		const __m128 cy = _mm_loadu_ps(bounds.centers(1) + index);
+		const __m128 cz = _mm_loadu_ps(bounds.centers(2) + index);
+		const __m128 ex = _mm_loadu_ps(bounds.extents(0) + index);
+		const __m128 ey = _mm_loadu_ps(bounds.extents(1) + index);
+		const __m128 ez = _mm_loadu_ps(bounds.extents(2) + index);
+
+		__m128 visible = _mm_castsi128_ps(_mm_set1_epi32(-1));
+
+		for (size_t plane = 0; plane < 6; ++plane)
+		{
+			__m128 distance = _mm_mul_ps(cx, _mm_set1_ps(planes.normal[0][plane]));
+			distance        = _mm_add_ps(distance, _mm_mul_ps(cy, _mm_set1_ps(planes.normal[1][plane])));
+			distance        = _mm_add_ps(distance, _mm_mul_ps(cz, _mm_set1_ps(planes.normal[2][plane])));
+			distance        = _mm_sub_ps(distance, _mm_set1_ps(planes.distance[plane]));
+
+			__m128 r = _mm_mul_ps(ex, _mm_set1_ps(planes.abs_normal[0][plane]));
+			r        = _mm_add_ps(r, _mm_mul_ps(ey, _mm_set1_ps(planes.abs_normal[1][plane])));
+			r        = _mm_add_ps(r, _mm_mul_ps(ez, _mm_set1_ps(planes.abs_normal[2][plane])));
+
+			visible = _mm_and_ps(visible, _mm_cmpge_ps(_mm_add_ps(distance, r), _mm_setzero_ps()));
+
+			if (_mm_movemask_ps(visible) == 0)
+				return 0;
+		}
+
+		return static_cast<uint64_t>(_mm_movemask_ps(visible));
+#elif ARCH_ARM && defined(__ARM_NEON)
+		const float32x4_t cx = vld1q_f32(bounds.centers(0) + index);
+		const float32x4_t cy = vld1q_f32(bounds.centers(1) + index);
+		const float32x4_t cz = vld1q_f32(bounds.centers(2) + index);
+		const float32x4_t ex = vld1q_f32(bounds.extents(0) + index);
+		const float32x4_t ey = vld1q_f32(bounds.extents(1) + index);
+		const float32x4_t ez = vld1q_f32(bounds.extents(2) + index);
+
+		uint32x4_t visible = vdupq_n_u32(~0u);
+
+		for (size_t plane = 0; plane < 6; ++plane)
+		{
+			float32x4_t distance = vmulq_n_f32(cx, planes.normal[0][plane]);
+			distance             = vmlaq_n_f32(distance, cy, planes.normal[1][plane]);
+			distance             = vmlaq_n_f32(distance, cz, planes.normal[2][plane]);
+			distance             = vsubq_f32(distance, vdupq_n_f32(planes.distance[plane]));
+
+			float32x4_t r = vmulq_n_f32(ex, planes.abs_normal[0][plane]);
+			r             = vmlaq_n_f32(r, ey, planes.abs_normal[1][plane]);
+			r             = vmlaq_n_f32(r, ez, planes.abs_normal[2][plane]);
+
+			visible = vandq_u32(visible, vcgeq_f32(vaddq_f32(distance, r), vdupq_n_f32(0.f)));
+		}
+
+		return (vgetq_lane_u32(visible, 0) & 1) | (vgetq_lane_u32(visible, 1) & 2) | (vgetq_lane_u32(visible, 2) & 4) |
+		       (vgetq_lane_u32(visible, 3) & 8);
+#else
+		uint64_t mask = 0;
+
+		for (size_t lane = 0; lane < 4; ++lane)
+		{
+			if (is_box_visible(planes, bounds, index + lane))
+				mask |= uint64_t(1) << lane;
+		}
+
+		return mask;
+#endif
+	}
+
+	const Frustum& Frustum::in_frustum(const BoundsArray& bounds, size_t begin, size_t end, uint64_t* visibility) const
+	{
+		const FrustumPlanes planes(*this);
+
+		for (size_t word = begin / 64, words_end = (end + 63) / 64; word < words_end; ++word)
+		{
+			const size_t first = word * 64;
+			const size_t last  = glm::min(first + 64, end);
+			uint64_t mask      = 0;
+			size_t index       = first;
+
+			for (; index + 4 <= last; index += 4)
+			{
+				mask |= visible_boxes_x4(planes, bounds, index) << (index - first);
+			}
+
+			for (; index < last; ++index)
+			{
+				if (is_box_visible(planes, bounds, index))
+					mask |= uint64_t(1) << (index - first);
+			}
+
+			visibility[word] = mask;
+		}
+
+		return *this;
 	}
 }// namespace Engine
@@ -1,11 +1,14 @@
 #include <Core/arguments.hpp>
 #include <Core/file_manager.hpp>
 #include <Core/filesystem/native_file_system.hpp>
+#include <Core/filesystem/packed_file_system.hpp>
 #include <Core/filesystem/root_filesystem.hpp>
 #include <Core/logger.hpp>
 #include <Engine/project.hpp>
+#include <Engine/settings.hpp>
 #include <Platform/platform.hpp>
 #include <ScriptEngine/script_engine.hpp>
+#include <filesystem>
 
 namespace Engine
 {
@@ -91,6 +94,37 @@ namespace Engine
 		delete system;
 	}
 
+	static VFS::FileSystem* create_assets_filesystem()
+	{
+		// Packed assets are read only, so they are used only when the project enables them. The editor keeps working with the
+		// assets directory, even if the pack file was built next to it
+		if (Settings::packed_assets)
+		{
+			Path pack = Project::assets_dir + VFS::PackedFileSystem::extension;
+
+			if (std::filesystem::is_regular_file(pack.str()))
+			{
+				auto fs = new VFS::PackedFileSystem(pack);
+
+				if (fs->is_valid())
+				{
+					info_log("Project", "Mounted packed assets '%s'", pack.c_str());
+					return fs;
+				}
+
+				delete fs;
+				error_log("Project", "Packed assets '%s' are invalid, using the assets directory", pack.c_str());
+			}
+			else
+			{
+				warn_log("Project", "Packed assets '%s' not found, using the assets directory", pack.c_str());
+			}
+		}
+
+		info_log("Project", "Mounted assets directory '%s'", Project::assets_dir.c_str());
+		return new VFS::NativeFileSystem(Project::assets_dir);
+	}
+
 	static void apply_project_config()
 	{
 		auto rfs = rootfs();
@@ -99,7 +133,7 @@ namespace Engine
 		using FS = VFS::NativeFileSystem;
 
 		rfs->mount("[configs_dir]:", "Configs", new FS(Project::configs_dir), delete_system);
-		rfs->mount("[assets_dir]:", "Assets", new FS(Project::assets_dir), delete_system);
+		rfs->mount("[assets_dir]:", "Assets", create_assets_filesystem(), delete_system);
 		rfs->mount("[scripts_dir]:", "Scripts", new FS(Project::scripts_dir), delete_system);
 		rfs->mount("[shaders_dir]:", "Shaders", new FS(Project::shaders_dir), delete_system);
 		rfs->mount("[localization_dir]:", "Localization", new FS(Project::localization_dir), delete_system);
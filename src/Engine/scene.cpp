@@ -1,3 +1,7 @@
+#include <Core/etl/frame_allocator.hpp>
+#include <Core/exception.hpp>
+#include <Core/parallel.hpp>
+#include <Core/thread_manager.hpp>
 #include <Core/threading.hpp>
 #include <Engine/ActorComponents/light_component.hpp>
 #include <Engine/ActorComponents/primitive_component.hpp>
@@ -5,6 +9,7 @@
 #include <Engine/Render/scene_renderer.hpp>
 #include <Engine/frustum.hpp>
 #include <Engine/scene.hpp>
+#include <bit>
 
 
 namespace Engine
@@ -45,6 +50,29 @@ namespace Engine
 		}
 	};
 
+	template<typename OctreeType>
+	class MovePrimitiveTask : public Task<MovePrimitiveTask<OctreeType>>
+	{
+		OctreeType* m_octree;
+		typename OctreeType::ValueType m_primitive;
+		AABB_3Df m_old_box;
+		AABB_3Df m_new_box;
+
+	public:
+		MovePrimitiveTask(OctreeType* octree, typename OctreeType::ValueType primitive, const AABB_3Df& old_box,
+		                  const AABB_3Df& new_box)
+		    : m_octree(octree), m_primitive(primitive), m_old_box(old_box), m_new_box(new_box)
+		{}
+
+		void execute() override
+		{
+			m_octree->move(m_old_box, m_new_box, m_primitive);
+		}
+	};
+
+	// Each chunk of the parallel scene traversal renders up to 16 * 64 primitives
+	static constexpr size_t words_per_render_chunk = 16;
+
 	Scene::Scene()
 	{
 		m_root_component = Object::new_instance<SceneComponent>("Root");
@@ -77,7 +105,62 @@ namespace Engine
 	Scene& Scene::build_views(SceneRenderer* renderer)
 	{
 		Frustum frustum = renderer->scene_view().camera_view();
-		build_views_internal(renderer, m_octree_render_thread.root_node(), frustum);
+
+		const size_t count = m_primitives_render_thread.size();
+
+		// Each job culls whole words of the visibility mask
+		FrameVector<uint64_t> visibility((count + 63) / 64);
+
+		auto render_words = [&](size_t begin, size_t end) {
+			for (size_t word = begin; word < end; ++word)
+			{
+				for (uint64_t mask = visibility[word]; mask; mask &= mask - 1)
+				{
+					m_primitives_render_thread[word * 64 + std::countr_zero(mask)]->render(renderer);
+				}
+			}
+		};
+
+		if (renderer->supports_parallel_recording())
+		{
+			// Chunks record commands to their own lists, which are submitted in the order of the chunks
+			const size_t chunks_count = (visibility.size() + words_per_render_chunk - 1) / words_per_render_chunk;
+			FrameVector<RenderCommandList> command_lists(chunks_count);
+
+			// Caller executes chunks together with the workers, other threads never execute jobs of the thread manager
+			parallel_for(chunks_count, 1, [&](size_t chunk) {
+				trinex_check(is_in_render_thread() || ThreadManager::worker_index() < ThreadManager::instance()->threads_count(),
+				             "Scene components must be rendered by the render thread or by the worker threads");
+
+				const size_t begin = chunk * words_per_render_chunk;
+				const size_t end   = glm::min(begin + words_per_render_chunk, visibility.size());
+
+				frustum.in_frustum(m_primitive_bounds_render_thread, begin * 64, glm::min(end * 64, count), visibility.data());
+
+				RenderCommandList::Scope scope(&command_lists[chunk]);
+				render_words(begin, end);
+			});
+
+			for (RenderCommandList& list : command_lists)
+			{
+				list.submit();
+			}
+		}
+		else
+		{
+			// Culling is performed on worker threads, but components are rendered in order on the render thread
+			parallel_for(visibility.size(), 0, [&](size_t begin, size_t end) {
+				frustum.in_frustum(m_primitive_bounds_render_thread, begin * 64, glm::min(end * 64, count), visibility.data());
+			});
+
+			render_words(0, visibility.size());
+		}
+
+		for (uint64_t mask : visibility)
+		{
+			renderer->statistics.visible_objects += std::popcount(mask);
+		}
+
 		build_views_internal(renderer, m_light_octree_render_thread.root_node(), frustum, true);
 		return *this;
 	}
@@ -87,6 +170,9 @@ namespace Engine
 		render_thread()->create_task<AddPrimitiveTask<Scene::PrimitiveOctree>>(&m_octree_render_thread, primitive,
 																			   primitive->bounding_box());
 		m_octree.push(primitive->bounding_box(), primitive);
+
+		call_in_render_thread(
+		        [this, primitive, box = primitive->bounding_box()]() { push_primitive_render_thread(primitive, box); });
 		return *this;
 	}
 
@@ -95,22 +181,70 @@ namespace Engine
 		render_thread()->create_task<RemovePrimitiveTask<Scene::PrimitiveOctree>>(&m_octree_render_thread, primitive,
 																				  primitive->bounding_box());
 		m_octree.remove(primitive->bounding_box(), primitive);
+
+		call_in_render_thread([this, primitive]() { remove_primitive_render_thread(primitive); });
+		return *this;
+	}
+
+	Scene& Scene::push_primitive_render_thread(PrimitiveComponent* primitive, const AABB_3Df& box)
+	{
+		auto [it, inserted] = m_primitive_indices_render_thread.try_emplace(primitive, m_primitives_render_thread.size());
+
+		if (inserted)
+		{
+			m_primitives_render_thread.push_back(primitive);
+			m_primitive_bounds_render_thread.push(box);
+		}
+		else
+		{
+			m_primitive_bounds_render_thread.set(it->second, box);
+		}
+		return *this;
+	}
+
+	Scene& Scene::remove_primitive_render_thread(PrimitiveComponent* primitive)
+	{
+		auto it = m_primitive_indices_render_thread.find(primitive);
+
+		if (it == m_primitive_indices_render_thread.end())
+			return *this;
+
+		// Last primitive is moved to the place of the removed one, bounds array does the same
+		const size_t index       = it->second;
+		PrimitiveComponent* last = m_primitives_render_thread.back();
+
+		m_primitives_render_thread[index]       = last;
+		m_primitive_indices_render_thread[last] = index;
+		m_primitive_bounds_render_thread.remove_swap(index);
+		m_primitives_render_thread.pop_back();
+		m_primitive_indices_render_thread.erase(primitive);
 		return *this;
 	}
 
 	Scene& Scene::update_primitive_transform(PrimitiveComponent* primitive)
 	{
-		remove_primitive(primitive);
+		const AABB_3Df old_box = primitive->bounding_box();
 		primitive->update_bounding_box();
-		add_primitive(primitive);
+		const AABB_3Df& new_box = primitive->bounding_box();
+
+		// Element usually stays in the same node of the octree, so it is moved instead of the removal and insertion
+		render_thread()->create_task<MovePrimitiveTask<Scene::PrimitiveOctree>>(&m_octree_render_thread, primitive, old_box,
+		                                                                        new_box);
+		m_octree.move(old_box, new_box, primitive);
+
+		call_in_render_thread([this, primitive, box = new_box]() { push_primitive_render_thread(primitive, box); });
 		return *this;
 	}
 
 	Scene& Scene::update_light_transform(LightComponent* light)
 	{
-		remove_light(light);
+		const AABB_3Df old_box = light->bounding_box();
 		light->update_bounding_box();
-		add_light(light);
+		const AABB_3Df& new_box = light->bounding_box();
+
+		render_thread()->create_task<MovePrimitiveTask<Scene::LightOctree>>(&m_light_octree_render_thread, light, old_box,
+		                                                                    new_box);
+		m_light_octree.move(old_box, new_box, light);
 		return *this;
 	}
 
@@ -8,13 +8,16 @@ namespace Engine::Settings
 	ENGINE_EXPORT String default_language      = "eng";
 	ENGINE_EXPORT String current_language      = "eng";
 	ENGINE_EXPORT int_t lz4_compression_level  = 0;
-	ENGINE_EXPORT int_t gc_max_object_per_tick = 1;
+	ENGINE_EXPORT int_t gc_tick_budget         = 500;
+	ENGINE_EXPORT int_t async_load_tick_budget = 2000;
 	ENGINE_EXPORT int_t fps_limit              = 60;
+	ENGINE_EXPORT int_t frames_in_flight       = 2;
 	ENGINE_EXPORT float screen_percentage      = 1.f;
 	ENGINE_EXPORT Vector<String> languages     = {"eng"};
 	ENGINE_EXPORT Vector<String> systems;
 	ENGINE_EXPORT Vector<String> plugins;
 	ENGINE_EXPORT bool debug_shaders = false;
+	ENGINE_EXPORT bool packed_assets = false;
 
 	namespace GPU
 	{
@@ -63,12 +66,15 @@ namespace Engine::Settings
 			bind_value(string, default_language);
 			bind_value(string, current_language);
 			bind_value(int, lz4_compression_level);
-			bind_value(int, gc_max_object_per_tick);
+			bind_value(int, gc_tick_budget);
+			bind_value(int, async_load_tick_budget);
 			bind_value(float, fps_limit);
+			bind_value(int, frames_in_flight);
 			bind_value(Engine::Vector<string>, languages);
 			bind_value(Engine::Vector<string>, systems);
 			bind_value(Engine::Vector<string>, plugins);
 			bind_value(Engine::Vector<string>, debug_shaders);
+			bind_value(bool, packed_assets);
 		}
 
 		{
@@ -1,3 +1,4 @@
+#include <Core/base_engine.hpp>
 #include <Core/reflection/class.hpp>
 #include <Core/threading.hpp>
 #include <Engine/ActorComponents/scene_component.hpp>
@@ -175,10 +176,11 @@ namespace Engine
 		if (!ignore_playing && actor->is_playing())
 		{
 			actor->stop_play();
-			// Perhaps the method will be called before World::update, so we skip one frame and only then delete the actor
+			// Perhaps the method will be called before World::update, and render thread can still use the actor in frames
+			// which are in flight, so we skip these frames and only then delete the actor
 			DestroyActorInfo info;
 			info.actor       = actor;
-			info.skip_frames = 1;
+			info.skip_frames = static_cast<byte>(engine_instance->frames_in_flight());
 			m_actors_to_destroy.push_back(info);
 			return *this;
 		}
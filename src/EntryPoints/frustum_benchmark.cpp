@@ -0,0 +1,130 @@
+#include <Core/arguments.hpp>
+#include <Core/entry_point.hpp>
+#include <Core/logger.hpp>
+#include <Core/reflection/class.hpp>
+#include <Engine/aabb.hpp>
+#include <Engine/bounds_array.hpp>
+#include <Engine/camera_types.hpp>
+#include <Engine/frustum.hpp>
+#include <bit>
+#include <chrono>
+#include <random>
+
+namespace Engine
+{
+	// Compares culling of the boxes one by one with the batched SIMD culling of the bounds array.
+	// Arguments: boxes - count of the boxes, by default 10k, 100k and 1M boxes are tested
+	class FrustumCullingBenchmark : public EntryPoint
+	{
+		declare_class(FrustumCullingBenchmark, EntryPoint);
+
+		static size_t argument_value(const char* name, size_t default_value)
+		{
+			auto argument = Arguments::find(name);
+
+			if (argument == nullptr || argument->type != Arguments::Type::String)
+				return default_value;
+
+			return std::stoull(argument->get<const String&>());
+		}
+
+		static CameraView camera_view()
+		{
+			CameraView view;
+			view.location        = {0.f, 0.f, 0.f};
+			view.forward_vector  = {0.f, 0.f, -1.f};
+			view.up_vector       = {0.f, 1.f, 0.f};
+			view.right_vector    = {1.f, 0.f, 0.f};
+			view.projection_mode = CameraProjectionMode::Perspective;
+			view.fov             = 75.f;
+			view.near_clip_plane = 0.1f;
+			view.far_clip_plane  = 500.f;
+			view.aspect_ratio    = 16.f / 9.f;
+			return view;
+		}
+
+		static void benchmark(size_t count)
+		{
+			std::mt19937 random(count);
+			std::uniform_real_distribution<float> location(-1000.f, 1000.f);
+			std::uniform_real_distribution<float> size(0.5f, 10.f);
+
+			Vector<AABB_3Df> boxes;
+			BoundsArray bounds;
+			boxes.reserve(count);
+			bounds.reserve(count);
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				const Vector3D min = {location(random), location(random), location(random)};
+				const AABB_3Df box(min, min + Vector3D(size(random), size(random), size(random)));
+				boxes.push_back(box);
+				bounds.push(box);
+			}
+
+			const Frustum frustum(camera_view());
+			const size_t iterations = glm::max<size_t>(1, 10000000 / count);
+
+			Vector<uint64_t> visibility((count + 63) / 64);
+			size_t scalar_visible = 0;
+			size_t simd_visible   = 0;
+
+			auto start = std::chrono::steady_clock::now();
+
+			for (size_t iteration = 0; iteration < iterations; ++iteration)
+			{
+				scalar_visible = 0;
+
+				for (const AABB_3Df& box : boxes)
+				{
+					scalar_visible += frustum.in_frustum(box) ? 1 : 0;
+				}
+			}
+
+			auto end                = std::chrono::steady_clock::now();
+			const float scalar_time = std::chrono::duration<float, std::milli>(end - start).count() / iterations;
+
+			start = std::chrono::steady_clock::now();
+
+			for (size_t iteration = 0; iteration < iterations; ++iteration)
+			{
+				frustum.in_frustum(bounds, 0, count, visibility.data());
+
+				simd_visible = 0;
+
+				for (uint64_t mask : visibility)
+				{
+					simd_visible += std::popcount(mask);
+				}
+			}
+
+			end                   = std::chrono::steady_clock::now();
+			const float simd_time = std::chrono::duration<float, std::milli>(end - start).count() / iterations;
+
+			info_log("FrustumCullingBenchmark", "Boxes: %zu, visible: %zu/%zu, scalar: %.3f ms, simd: %.3f ms, speedup: %.2fx", count,
+			         scalar_visible, simd_visible, scalar_time, simd_time, scalar_time / glm::max(simd_time, 0.0001f));
+
+			if (scalar_visible != simd_visible)
+				error_log("FrustumCullingBenchmark", "Scalar and SIMD culling results differ!");
+		}
+
+	public:
+		int_t execute() override
+		{
+			if (size_t count = argument_value("boxes", 0))
+			{
+				benchmark(count);
+				return 0;
+			}
+
+			for (size_t count : {10000, 100000, 1000000})
+			{
+				benchmark(count);
+			}
+
+			return 0;
+		}
+	};
+
+	implement_engine_class_default_init(FrustumCullingBenchmark, 0);
+}// namespace Engine
@@ -0,0 +1,103 @@
+#include <Core/arguments.hpp>
+#include <Core/entry_point.hpp>
+#include <Core/garbage_collector.hpp>
+#include <Core/logger.hpp>
+#include <Core/parallel.hpp>
+#include <Core/reflection/class.hpp>
+#include <Core/reflection/property.hpp>
+#include <Core/thread_manager.hpp>
+#include <chrono>
+#include <random>
+
+namespace Engine
+{
+	class GCBenchmarkNode : public Object
+	{
+		declare_class(GCBenchmarkNode, Object);
+
+	public:
+		Vector<Object*> references;
+	};
+
+	implement_engine_class(GCBenchmarkNode, 0)
+	{
+		auto* self = static_class_instance();
+		trinex_refl_prop(self, This, references);
+	}
+
+	// Measures throughput of the garbage collector mark phase on the synthetic object graph.
+	// Arguments: objects - count of objects in the graph, references - count of references of each object
+	class GCMarkBenchmark : public EntryPoint
+	{
+		declare_class(GCMarkBenchmark, EntryPoint);
+
+		static size_t argument_value(const char* name, size_t default_value)
+		{
+			auto argument = Arguments::find(name);
+
+			if (argument == nullptr || argument->type != Arguments::Type::String)
+				return default_value;
+
+			return std::stoull(argument->get<const String&>());
+		}
+
+	public:
+		int_t execute() override
+		{
+			const size_t objects_count    = glm::max<size_t>(1, argument_value("objects", 100000));
+			const size_t references_count = argument_value("references", 4);
+
+			Vector<GCBenchmarkNode*> nodes;
+			nodes.reserve(objects_count);
+
+			for (size_t i = 0; i < objects_count; ++i)
+			{
+				nodes.push_back(Object::new_instance<GCBenchmarkNode>());
+			}
+
+			std::mt19937 random(objects_count);
+			std::uniform_int_distribution<size_t> distribution(0, objects_count - 1);
+
+			for (size_t i = 0; i < objects_count; ++i)
+			{
+				GCBenchmarkNode* node = nodes[i];
+
+				// Each hundredth object is a root, others are reachable only through references
+				if (i % 100 == 0)
+					node->flags(Object::StandAlone, true);
+
+				for (size_t j = 0; j < references_count; ++j)
+				{
+					node->references.push_back(nodes[distribution(random)]);
+				}
+			}
+
+			ThreadManager* manager   = ThreadManager::instance();
+			const size_t max_workers = glm::max<size_t>(1, std::thread::hardware_concurrency());
+
+			for (size_t workers = 1; workers <= max_workers; workers *= 2)
+			{
+				manager->resize(workers);
+
+				auto start    = std::chrono::steady_clock::now();
+				size_t traced = GarbageCollector::mark_all();
+				auto end      = std::chrono::steady_clock::now();
+
+				const float time = std::chrono::duration<float, std::milli>(end - start).count();
+				info_log("GCMarkBenchmark", "Threads: %zu, traced objects: %zu, time: %.3f ms, throughput: %.1f objects/ms",
+				         Parallel::threads_count(), traced, time, static_cast<float>(traced) / glm::max(time, 0.001f));
+			}
+
+			manager->resize(ThreadManager::default_threads_count());
+
+			for (GCBenchmarkNode* node : nodes)
+			{
+				node->flags(Object::StandAlone, false);
+			}
+
+			return 0;
+		}
+	};
+
+	implement_engine_class_default_init(GCMarkBenchmark, 0);
+}// namespace Engine
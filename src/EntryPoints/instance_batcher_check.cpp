@@ -0,0 +1,211 @@
+#include <Core/entry_point.hpp>
+#include <Core/exception.hpp>
+#include <Core/logger.hpp>
+#include <Core/reflection/class.hpp>
+#include <Core/thread.hpp>
+#include <Core/threading.hpp>
+#include <Engine/ActorComponents/scene_component.hpp>
+#include <Engine/Render/instance_batcher.hpp>
+#include <Engine/Render/scene_renderer.hpp>
+#include <Graphics/pipeline.hpp>
+#include <Graphics/shader.hpp>
+#include <Graphics/shader_material.hpp>
+
+namespace Engine
+{
+	// Checks grouping of the mesh draws by the instance batcher. Draws don't reference GPU resources, so the check runs
+	// with the None RHI, which is used by all entry points
+	class InstanceBatcherCheck : public EntryPoint
+	{
+		declare_class(InstanceBatcherCheck, EntryPoint);
+
+		class CheckPass : public RenderPass
+		{
+		public:
+			CheckPass() = default;
+		};
+
+		size_t m_failed = 0;
+
+		void check(bool condition, const char* message)
+		{
+			if (!condition)
+			{
+				error_log("InstanceBatcherCheck", "Check failed: %s", message);
+				++m_failed;
+			}
+		}
+
+		static Material* create_material(bool is_instanced)
+		{
+			Material* material   = Object::new_instance<ShaderMaterial>();
+			VertexShader* shader = material->pipeline->vertex_shader(true);
+
+			shader->attributes.emplace_back(VertexAttributeInputRate::Vertex, VertexBufferSemantic::Position, 0, 0, 0);
+
+			if (is_instanced)
+			{
+				for (byte column = 0; column < 4; ++column)
+				{
+					shader->attributes.emplace_back(VertexAttributeInputRate::Instance, VertexBufferSemantic::Transform, column,
+					                                column + 1, column + 1);
+				}
+			}
+
+			return material;
+		}
+
+		static RenderPass::MeshDraw mesh_draw(MaterialInterface* material, size_t vertices_count,
+		                                      SceneComponent* component = nullptr)
+		{
+			RenderPass::MeshDraw draw;
+			draw.material       = material;
+			draw.component      = component;
+			draw.vertices_count = vertices_count;
+			return draw;
+		}
+
+		// Pass is created in the logic thread, while the draws are recorded and executed in the render thread, in the same way
+		// as the scene renderer uses its passes
+		void check_render_pass(Material* instanced, Material* plain)
+		{
+			SceneRenderer renderer;
+			RenderPass* pass = renderer.create_pass<CheckPass>();
+			renderer.statistics.reset();
+
+			SceneComponent* components[3];
+
+			for (SceneComponent*& component : components)
+			{
+				component = Object::new_instance<SceneComponent>();
+				component->spawned();
+			}
+
+			String error;
+			bool is_rendered = false;
+
+			call_in_render_thread([&]() {
+				try
+				{
+					for (SceneComponent* component : components)
+					{
+						pass->draw_mesh(mesh_draw(instanced, 36, component));
+					}
+
+					pass->draw_mesh(mesh_draw(plain, 36, components[0]));
+					pass->render(nullptr);
+					pass->clear();
+					is_rendered = true;
+				}
+				catch (const std::exception& exception)
+				{
+					error = exception.what();
+				}
+			});
+
+			render_thread()->wait();
+
+			if (!is_rendered)
+				error_log("InstanceBatcherCheck", "Render pass failed: %s", error.c_str());
+
+			check(is_rendered, "render pass is executed in the render thread");
+			check(renderer.statistics.instanced_draws == 1, "draws of the components are merged into one instanced draw");
+			check(renderer.statistics.instances == std::size(components), "instanced draw renders all components");
+
+			for (SceneComponent* component : components)
+			{
+				component->destroyed();
+			}
+		}
+
+	public:
+		int_t execute() override
+		{
+			Material* instanced = create_material(true);
+			Material* plain     = create_material(false);
+
+			check(InstanceBatcher::is_instanced(instanced), "material with transform attributes must be instanced");
+			check(!InstanceBatcher::is_instanced(plain), "material without transform attributes must not be instanced");
+			check(!InstanceBatcher::is_instanced(nullptr), "null material must not be instanced");
+
+			// Draws are sorted by the state, surfaces differ by the count of vertices
+			const RenderPass::MeshDraw draws[] = {
+			        mesh_draw(instanced, 36), mesh_draw(instanced, 36), mesh_draw(instanced, 36),
+			        mesh_draw(instanced, 24), mesh_draw(instanced, 24), mesh_draw(plain, 36),
+			        mesh_draw(plain, 36),
+			};
+
+			const RenderPass::MeshDraw* pointers[std::size(draws)];
+
+			for (size_t index = 0; index < std::size(draws); ++index)
+			{
+				pointers[index] = &draws[index];
+			}
+
+			InstanceBatcher batcher;
+			batcher.add(pointers, 4);
+			batcher.add(pointers + 4, std::size(draws) - 4);
+
+			auto& batches   = batcher.batches();
+			auto& instances = batcher.instances();
+
+			// Ranges added separately are not merged, even if they contain the same surface
+			struct Expected {
+				const RenderPass::MeshDraw* draw;
+				size_t first_instance;
+				size_t instances_count;
+				bool is_instanced;
+			};
+
+			const Expected expected[] = {
+			        {&draws[0], 0, 3, true}, {&draws[3], 3, 1, true},  {&draws[4], 4, 1, true},
+			        {&draws[5], 5, 1, false}, {&draws[6], 6, 1, false},
+			};
+
+			check(batches.size() == std::size(expected), "count of batches");
+			check(instances.size() == std::size(draws), "count of instances");
+
+			for (size_t index = 0; index < glm::min(batches.size(), std::size(expected)); ++index)
+			{
+				const InstanceBatcher::Batch& batch = batches[index];
+				const Expected& value               = expected[index];
+
+				check(batch.draw == value.draw, "first draw of the batch");
+				check(batch.first_instance == value.first_instance, "first instance of the batch");
+				check(batch.instances_count == value.instances_count, "instances count of the batch");
+				check(batch.is_instanced == value.is_instanced, "instancing of the batch");
+
+				for (size_t instance = 0; instance < batch.instances_count; ++instance)
+				{
+					const size_t draw = index == 0 ? instance : value.first_instance;
+					check(instances[batch.first_instance + instance] == &draws[draw], "instances of the batch are contiguous");
+				}
+			}
+
+			// Columns are stored one after another, each column contains all instances
+			const size_t count = instances.size();
+
+			for (byte column = 0; column < 4; ++column)
+			{
+				check(batcher.column_offset(0, column) == column * count * sizeof(Vector4D), "offset of the column");
+				check(batcher.column_offset(2, column) == (column * count + 2) * sizeof(Vector4D), "offset of the instance");
+			}
+
+			batcher.clear();
+			check(batcher.batches().empty() && batcher.instances().empty(), "clear removes batches and instances");
+
+			check_render_pass(instanced, plain);
+
+			if (m_failed)
+			{
+				error_log("InstanceBatcherCheck", "%zu checks failed", m_failed);
+				return 1;
+			}
+
+			info_log("InstanceBatcherCheck", "All checks passed");
+			return 0;
+		}
+	};
+
+	implement_engine_class_default_init(InstanceBatcherCheck, 0);
+}// namespace Engine
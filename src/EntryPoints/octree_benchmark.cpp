@@ -0,0 +1,194 @@
+#include <Core/arguments.hpp>
+#include <Core/entry_point.hpp>
+#include <Core/logger.hpp>
+#include <Core/reflection/class.hpp>
+#include <Engine/aabb.hpp>
+#include <Engine/octree.hpp>
+#include <Engine/ray.hpp>
+#include <chrono>
+#include <random>
+
+namespace Engine
+{
+	// Measures insertion, movement and queries of the octree on random boxes. Ray queries traverse the octree in the same
+	// way as the editor raycast. Arguments: elements - count of the elements, by default 10k and 100k elements are tested
+	class OctreeBenchmark : public EntryPoint
+	{
+		declare_class(OctreeBenchmark, EntryPoint);
+
+		using Tree  = Octree<uint32_t>;
+		using Node  = Tree::Node;
+		using Clock = std::chrono::steady_clock;
+
+		struct QueryStats {
+			size_t nodes      = 0;
+			size_t candidates = 0;
+			size_t hits       = 0;
+		};
+
+		static size_t argument_value(const char* name, size_t default_value)
+		{
+			auto argument = Arguments::find(name);
+
+			if (argument == nullptr || argument->type != Arguments::Type::String)
+				return default_value;
+
+			return std::stoull(argument->get<const String&>());
+		}
+
+		static float elapsed(Clock::time_point start)
+		{
+			return std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+		}
+
+		static void query(const Node* node, const AABB_3Df& box, const Vector<AABB_3Df>& boxes, QueryStats& stats)
+		{
+			if (node == nullptr || !node->box().intersect(box))
+				return;
+
+			++stats.nodes;
+			stats.candidates += node->values.size();
+
+			for (uint32_t value : node->values)
+			{
+				stats.hits += boxes[value].intersect(box) ? 1 : 0;
+			}
+
+			for (byte index = 0; index < 8; ++index)
+			{
+				query(node->child_at(index), box, boxes, stats);
+			}
+		}
+
+		static void query(const Node* node, const Ray& ray, const Vector<AABB_3Df>& boxes, QueryStats& stats)
+		{
+			if (node == nullptr)
+				return;
+
+			Vector2D intersect = node->box().intersect(ray);
+
+			if (intersect.x > intersect.y)
+				return;
+
+			++stats.nodes;
+			stats.candidates += node->values.size();
+
+			for (uint32_t value : node->values)
+			{
+				intersect = boxes[value].intersect(ray);
+				stats.hits += intersect.x < intersect.y ? 1 : 0;
+			}
+
+			for (byte index = 0; index < 8; ++index)
+			{
+				query(node->child_at(index), ray, boxes, stats);
+			}
+		}
+
+		static size_t nodes_count(const Node* node)
+		{
+			if (node == nullptr)
+				return 0;
+
+			size_t count = 1;
+
+			for (byte index = 0; index < 8; ++index)
+			{
+				count += nodes_count(node->child_at(index));
+			}
+
+			return count;
+		}
+
+		static void benchmark(size_t count)
+		{
+			static constexpr size_t queries_count = 100;
+
+			std::mt19937 random(count);
+			std::uniform_real_distribution<float> location(-1000.f, 1000.f);
+			std::uniform_real_distribution<float> extent(0.5f, 4.f);
+			std::uniform_real_distribution<float> offset(-5.f, 5.f);
+			std::uniform_real_distribution<float> direction(-1.f, 1.f);
+
+			Vector<AABB_3Df> boxes(count);
+
+			for (AABB_3Df& box : boxes)
+			{
+				const Vector3D center  = {location(random), location(random), location(random)};
+				const Vector3D extents = {extent(random), extent(random), extent(random)};
+				box                    = AABB_3Df(center - extents, center + extents);
+			}
+
+			Tree tree;
+
+			auto start = Clock::now();
+
+			for (size_t index = 0; index < count; ++index)
+			{
+				tree.push(boxes[index], static_cast<uint32_t>(index));
+			}
+
+			const float insert_time = elapsed(start);
+			start                   = Clock::now();
+
+			for (size_t index = 0; index < count; ++index)
+			{
+				const AABB_3Df box = boxes[index] + Vector3D(offset(random), offset(random), offset(random));
+				tree.move(boxes[index], box, static_cast<uint32_t>(index));
+				boxes[index] = box;
+			}
+
+			const float move_time = elapsed(start);
+
+			QueryStats box_stats;
+			start = Clock::now();
+
+			for (size_t index = 0; index < queries_count; ++index)
+			{
+				const Vector3D center = {location(random), location(random), location(random)};
+				query(tree.root_node(), AABB_3Df(center - Vector3D(50.f), center + Vector3D(50.f)), boxes, box_stats);
+			}
+
+			const float box_query_time = elapsed(start);
+
+			QueryStats ray_stats;
+			start = Clock::now();
+
+			for (size_t index = 0; index < queries_count; ++index)
+			{
+				const Vector3D origin = {location(random), location(random), location(random)};
+				const Vector3D dir    = glm::normalize(Vector3D(direction(random), direction(random), direction(random)) + 0.001f);
+				query(tree.root_node(), Ray(origin, dir), boxes, ray_stats);
+			}
+
+			const float ray_query_time = elapsed(start);
+			const size_t nodes         = nodes_count(tree.root_node());
+
+			info_log("OctreeBenchmark", "Elements: %zu, nodes: %zu, insert: %.3f ms, move: %.3f ms", count, nodes, insert_time,
+			         move_time);
+			info_log("OctreeBenchmark", "%zu box queries: %.3f ms, nodes: %zu, candidates: %zu, hits: %zu", queries_count,
+			         box_query_time, box_stats.nodes, box_stats.candidates, box_stats.hits);
+			info_log("OctreeBenchmark", "%zu ray queries: %.3f ms, nodes: %zu, candidates: %zu, hits: %zu", queries_count,
+			         ray_query_time, ray_stats.nodes, ray_stats.candidates, ray_stats.hits);
+		}
+
+	public:
+		int_t execute() override
+		{
+			if (size_t count = argument_value("elements", 0))
+			{
+				benchmark(count);
+				return 0;
+			}
+
+			for (size_t count : {10000, 100000})
+			{
+				benchmark(count);
+			}
+
+			return 0;
+		}
+	};
+
+	implement_engine_class_default_init(OctreeBenchmark, 0);
+}// namespace Engine
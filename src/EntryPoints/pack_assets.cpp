@@ -0,0 +1,44 @@
+#include <Core/arguments.hpp>
+#include <Core/entry_point.hpp>
+#include <Core/filesystem/packed_file_system.hpp>
+#include <Core/filesystem/root_filesystem.hpp>
+#include <Core/logger.hpp>
+#include <Core/reflection/class.hpp>
+#include <Engine/project.hpp>
+
+namespace Engine
+{
+	// Packs the assets directory of the project into the pack file, which is mounted instead of the directory on startup.
+	// Arguments: input - native path to the directory, output - native path to the pack file
+	class PackAssets : public EntryPoint
+	{
+		declare_class(PackAssets, EntryPoint);
+
+		static Path argument_value(const char* name, const Path& default_value)
+		{
+			auto argument = Arguments::find(name);
+
+			if (argument == nullptr || argument->type != Arguments::Type::String)
+				return default_value;
+
+			return argument->get<const String&>();
+		}
+
+	public:
+		int_t execute() override
+		{
+			const Path input  = argument_value("input", rootfs()->native_path(Project::assets_dir));
+			const Path output = argument_value("output", input + VFS::PackedFileSystem::extension);
+
+			if (input.empty())
+			{
+				error_log("PackAssets", "Input directory is not specified!");
+				return -1;
+			}
+
+			return rootfs()->pack_native_folder(input, output) ? 0 : -1;
+		}
+	};
+
+	implement_engine_class_default_init(PackAssets, 0);
+}// namespace Engine
@@ -123,6 +123,7 @@ namespace Engine
 	implement_engine_class_default_init(NormalDynamicVertexBuffer, 0);
 	implement_engine_class_default_init(TangentDynamicVertexBuffer, 0);
 	implement_engine_class_default_init(BitangentDynamicVertexBuffer, 0);
+	implement_engine_class_default_init(TransformDynamicVertexBuffer, 0);
 
 	//////////////////////////// INDEX BUFFER ////////////////////////////
 
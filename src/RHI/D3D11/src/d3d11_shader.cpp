@@ -26,6 +26,8 @@ namespace Engine
 				return "BLENDWEIGHT";
 			case VertexBufferSemantic::BlendIndices:
 				return "BLENDINDICES";
+			case VertexBufferSemantic::Transform:
+				return "TRANSFORM";
 			default:
 				throw EngineException("Undefined semantic");
 		}